@@ -13,6 +13,7 @@
 
 #include <unstandard.h>
 #include <hexagonparadigm.h>
+#include <taskpool.h>
 
 /**
  * @brief Sructure holding the data describing a cell automaton.
@@ -28,25 +29,300 @@ typedef struct cell_automaton_t cell_automaton_t;
 typedef void (*apply_to_cell_func_t)(void *target, void *neighbors[DIRECTIONS_NB]);
 
 /**
- * @brief Applies the automaton on its anonymous bidimensional array. The array is modified by the operation.
+ * @brief Rows handed to a row function, the neighbors of a row's cells are all found in those.
+ */
+typedef enum row_neighborhood_t {
+    ROW_ABOVE,      ///< row above the targeted row
+    ROW_CURRENT,    ///< targeted row, as it was before the current iteration
+    ROW_BELOW,      ///< row below the targeted row
+
+    ROW_NEIGHBORHOOD_NB,    ///< number of rows handed to a row function
+} row_neighborhood_t;
+
+/**
+ * @brief Type of a function pointer accepted by the automaton, changing a span of cells of a row at once.
+ * A row can be handed out in several consecutive spans, depending on the traversal order. Each span can read one
+ * more cell on each side (at index -1 and `width`), wrapping around the array at its edges.
+ * The neighbors of cell x are the cells x - 1 and x + 1 of the current row, and the cells x - 1 and x of the rows
+ * above and below if the row is even, or x and x + 1 if the row is odd.
+ * @param[inout] target first cell of the targeted span, which states will change.
+ * @param[in] rows first cells of the neighboring spans ordered by `row_neighborhood_t`.
+ * @param[in] width number of cells in the span.
+ * @param[in] parity 0 if the row is even, 1 if it is odd.
+ */
+typedef void (*apply_to_row_func_t)(void *target, void *rows[ROW_NEIGHBORHOOD_NB], size_t width, u32 parity);
+
+/**
+ * @brief Type of a function pointer accepted by the automaton, reading the cells up to some distance of its target.
+ * The neighbors are ordered ring after ring, each ring starting with its cell straight to the east and going around
+ * clockwise : the first 6 neighbors are the immediate neighbors, in the order of `cell_direction_t`.
+ * @param[inout] target targeted cell which state will change.
+ * @param[in] center targeted cell, as it was before the current iteration.
+ * @param[in] offsets offsets in bytes from `center` to each neighbor.
+ * @param[in] neighbors_nb number of neighbors, `OTOMATON_DISK_NEIGHBORS_NB()` of the radius.
+ */
+typedef void (*apply_to_disk_func_t)(void *target, void *center, const i64 *offsets, size_t neighbors_nb);
+
+/**
+ * @brief Type of a function pointer reading a number from a cell.
+ * @param[in] cell read cell.
+ * @return f32 number read from the cell.
+ */
+typedef f32 (*cell_value_func_t)(const void *cell);
+
+/**
+ * @brief Type of a function pointer telling if a cell belongs to a set of cells.
+ * @param[in] cell tested cell.
+ * @return u32 1 if the cell belongs to the set, 0 otherwise.
+ */
+typedef u32 (*cell_predicate_func_t)(const void *cell);
+
+/// number of cells at most `_r` cells away from a cell, the cell excluded
+#define OTOMATON_DISK_NEIGHBORS_NB(_r) (3u * (_r) * ((_r) + 1u))
+
+/// address of the neighbor of index `_i` handed to a disk function
+#define OTOMATON_DISK_NEIGHBOR(_center, _offsets, _i) ((_center) + (_offsets)[(_i)])
+
+/**
+ * @brief Defines a static row function `_name` applying a per-cell function to each cell of a span, in order.
+ * Expanded in the file defining the per-cell function, the compiler knows the size of the cells and can inline the
+ * per-cell function instead of calling it through a pointer for each cell. The results are the same as applying
+ * the per-cell function with `otomaton_apply()`.
+ * @param _name name of the defined row function, of type `apply_to_row_func_t`
+ * @param _cell_type type of the cells of the array
+ * @param _cell_function per-cell function, of type `apply_to_cell_func_t`
+ */
+#define OTOMATON_ROW_KERNEL(_name, _cell_type, _cell_function) \
+static void _name(void *target, void *rows[ROW_NEIGHBORHOOD_NB], size_t width, u32 parity) { \
+    _cell_type *cells = (_cell_type *) target; \
+    _cell_type *above = (_cell_type *) rows[ROW_ABOVE]; \
+    _cell_type *current = (_cell_type *) rows[ROW_CURRENT]; \
+    _cell_type *below = (_cell_type *) rows[ROW_BELOW]; \
+    const i64 shift = (i64) parity - 1; \
+    void *neighbors[DIRECTIONS_NB] = { NULL }; \
+    \
+    for (i64 x = 0 ; x < (i64) width ; x++) { \
+        neighbors[DIRECTION_E]  = current + x + 1; \
+        neighbors[DIRECTION_SE] = below + x + shift + 1; \
+        neighbors[DIRECTION_SW] = below + x + shift; \
+        neighbors[DIRECTION_W]  = current + x - 1; \
+        neighbors[DIRECTION_NW] = above + x + shift; \
+        neighbors[DIRECTION_NE] = above + x + shift + 1; \
+        _cell_function(cells + x, neighbors); \
+    } \
+}
+
+/**
+ * @brief Options changing the way the automaton applies a function, as bit offsets in a flag set.
+ */
+typedef enum otomaton_apply_option_t {
+    OTOMATON_OPTION_SEQUENTIAL,     ///< the function relies on some shared state (e.g. the RNG) and must visit the cells one by one, in order, on the calling thread
+    OTOMATON_OPTION_FRONTIER,       ///< the function only depends on its target and neighbors : only the cells around the last changes are visited, on the calling thread (per-cell functions only)
+    OTOMATON_OPTION_CONVERGE,       ///< the iterations stop early once two in a row changed no more cells than the tolerance, the result being the same as going through all of them if the tolerance is 0
+    OTOMATON_OPTION_TIME_BLOCKS,    ///< several iterations are run on a few rows at a time while they are in the cache, in the traversal order of rows and with the same results (ignored along with the other options)
+    OTOMATON_OPTION_IN_PLACE,       ///< the cells are changed in place, a third of them at a time so no two neighbors change together : cells see the changes already made to their neighbors by the same iteration, which settles faster but gives other results (per-cell functions only, only the convergence option still applies, always on for an automaton created in place only)
+    OTOMATON_OPTION_MASKED,         ///< only the cells of the automaton's mask are visited, the function must leave the others unchanged (see `otomaton_set_mask()`)
+
+    OTOMATON_OPTIONS_NB,            ///< total number of options
+} otomaton_apply_option_t;
+
+/// builds an option set from a single option
+#define OTOMATON_OPTION(_o) ((flag_set8_t) (0x01 << (_o)))
+
+/**
+ * @brief What an automaton is able to do, decided once at its creation since it sets what its block holds.
+ */
+typedef struct otomaton_capacity_t {
+    /// 1 for the automaton to hold a single buffer, changed in place : it then only applies per-cell functions, always with the in-place option
+    u32 in_place_only;
+    /// largest radius `otomaton_apply_disk()` will be given, the halo of the buffers being made as wide (0 or 1 for the immediate neighbors only)
+    size_t disk_radius;
+    /// 1 for the tracking of the frontier option to be carved from the automaton's block, instead of being allocated the first time the option is used
+    u32 has_frontier;
+    /// 1 for room for any mask to be carved from the automaton's block, instead of being allocated by each `otomaton_set_mask()`
+    u32 has_mask;
+} otomaton_capacity_t;
+
+/**
+ * @brief Types of the numbers a filter can be applied to.
+ */
+typedef enum otomaton_scalar_t {
+    OTOMATON_SCALAR_F32,            ///< `f32`
+    OTOMATON_SCALAR_I8,             ///< `i8`, rounded to the nearest
+    OTOMATON_SCALAR_I16,            ///< `i16`, rounded to the nearest
+    OTOMATON_SCALAR_U16,            ///< `u16`, rounded to the nearest
+
+    OTOMATON_SCALARS_NB,            ///< number of types
+} otomaton_scalar_t;
+
+/**
+ * @brief Kernels of the filters, made of running means along the three axes of the hexagons (east to west,
+ * north-west to south-east and north-east to south-west).
+ */
+typedef enum otomaton_filter_kernel_t {
+    OTOMATON_FILTER_BOX,            ///< one running mean along each axis
+    OTOMATON_FILTER_GAUSSIAN,       ///< three running means along each axis, close to a gaussian
+
+    OTOMATON_FILTER_KERNELS_NB,     ///< number of kernels
+} otomaton_filter_kernel_t;
+
+/**
+ * @brief Orders in which the cells are visited when the automaton sweeps over its array. They all give the same
+ * results, but some keep more of the array in the cache than others.
+ */
+typedef enum otomaton_traversal_t {
+    OTOMATON_TRAVERSAL_ROWS,        ///< row after row (default)
+    OTOMATON_TRAVERSAL_TILES,       ///< square tiles fitting in the L2 cache, row after row of tiles
+    OTOMATON_TRAVERSAL_MORTON,      ///< square tiles fitting in the L2 cache, along a Morton (Z-order) curve
+
+    OTOMATON_TRAVERSALS_NB,         ///< number of traversal orders
+} otomaton_traversal_t;
+
+/**
+ * @brief Applies the automaton on its anonymous bidimensional array. The array is modified by the operation, and
+ * might be moved to another location : it must be fetched again with `otomaton_array()` afterward.
  * If the automaton's function is NULL, nothing is done to the array.
+ * Each iteration is split in bands of rows submitted to the automaton's task pool, unless the sequential option is given.
+ * Without the convergence option, a band starts its next iteration as soon as the bands around it are done with the last one.
+ * The result does not depend on the number of threads as long as the function only writes to its target cell.
  * 
  * @param[inout] automaton automaton to apply to the array, can be NULL (in this case, nothing will be done)
  * @param[in] iteration_nb number of times the function is applied to each cell
  * @param[in] function function to apply to each cell
+ * @param[in] options set of `otomaton_apply_option_t` bit offsets, 0 for the default behavior
+ * @param[in] tolerance with the convergence option, fraction of the cells that can change in an iteration that is still considered settled
+ * @return u32 number of iterations actually done, less than `iteration_nb` if the array converged
  */
-void otomaton_apply(cell_automaton_t *automaton, u32 iteration_nb, apply_to_cell_func_t function);
+u32 otomaton_apply(cell_automaton_t *automaton, u32 iteration_nb, apply_to_cell_func_t function, flag_set8_t options, f32 tolerance);
+
+/**
+ * @brief Applies the automaton on its anonymous bidimensional array one row at a time, otherwise behaves as `otomaton_apply()`.
+ * With the sequential option, the rows are visited in order on the calling thread.
+ * 
+ * @param[inout] automaton automaton to apply to the array, can be NULL (in this case, nothing will be done)
+ * @param[in] iteration_nb number of times the function is applied to each row
+ * @param[in] function function to apply to each row
+ * @param[in] options set of `otomaton_apply_option_t` bit offsets, 0 for the default behavior
+ * @param[in] tolerance with the convergence option, fraction of the cells that can change in an iteration that is still considered settled
+ * @return u32 number of iterations actually done, less than `iteration_nb` if the array converged, 0 for an automaton created in place only
+ */
+u32 otomaton_apply_rows(cell_automaton_t *automaton, u32 iteration_nb, apply_to_row_func_t function, flag_set8_t options, f32 tolerance);
+
+/**
+ * @brief Applies the automaton on its anonymous bidimensional array, each cell reading every cell up to some distance
+ * of it, otherwise behaves as `otomaton_apply()`. The frontier, time blocks and in-place options do not apply, and
+ * with the sequential option the rows are visited in order on the calling thread.
+ * 
+ * @param[inout] automaton automaton to apply to the array, can be NULL (in this case, nothing will be done)
+ * @param[in] iteration_nb number of times the function is applied to each cell
+ * @param[in] radius distance, in cells, up to which the neighbors are handed to the function
+ * @param[in] function function to apply to each cell
+ * @param[in] options set of `otomaton_apply_option_t` bit offsets, 0 for the default behavior
+ * @param[in] tolerance with the convergence option, fraction of the cells that can change in an iteration that is still considered settled
+ * @return u32 number of iterations actually done, 0 if the radius is wider than the automaton's capacity or for an automaton created in place only
+ */
+u32 otomaton_apply_disk(cell_automaton_t *automaton, u32 iteration_nb, size_t radius, apply_to_disk_func_t function, flag_set8_t options, f32 tolerance);
+
+/**
+ * @brief Sums, for each cell of the array, a number read from every cell up to some distance of it, the cell included.
+ * Each disk is summed as one run of cells for each of its rows, each run being slid along its row : the cost of a
+ * cell grows with the radius, and not with the number of cells of its disk.
+ * 
+ * @param[inout] automaton target automaton, can be NULL (in this case, nothing will be done)
+ * @param[in] radius distance, in cells, up to which the cells are summed
+ * @param[in] value function reading the summed number from a cell
+ * @param[out] out_sums sum for each cell, row after row without any padding
+ * @return u32 1 if the sums were computed, 0 otherwise
+ */
+u32 otomaton_disk_sums(cell_automaton_t *automaton, size_t radius, cell_value_func_t value, f32 *out_sums);
+
+/**
+ * @brief Blurs a number held by each cell of the array, in place, with running means along the three axes of the
+ * hexagons. Each mean is slid along its line of cells : the cost of a cell does not depend on the radius. The
+ * array is not moved, so this can be called by code writing to it from the outside.
+ * 
+ * @param[inout] automaton target automaton, can be NULL (in this case, nothing will be done)
+ * @param[in] field_offset offset of the number from the start of a cell, in bytes
+ * @param[in] field_type type of the number
+ * @param[in] kernel kernel of the filter
+ * @param[in] radius number of cells on each side of a cell taken in each running mean
+ * @return u32 1 if the field was filtered, 0 otherwise
+ */
+u32 otomaton_filter(cell_automaton_t *automaton, size_t field_offset, otomaton_scalar_t field_type, otomaton_filter_kernel_t kernel, size_t radius);
 
 /**
  * @brief Creates an automaton on the heap and returns a pointer to it.
+ * The automaton owns the array on which every operation will be applied. Its content is left uninitialized.
+ * The automaton, its array and everything an iteration always needs are allocated at once, as a single block of
+ * `otomaton_footprint()` bytes.
+ * 
+ * @param[in] width width, in number of elements of a row
+ * @param[in] height height, in number of rows
+ * @param[in] stride size in bytes of an element
+ * @param[in] pool pool running the bands of rows of each iteration, not owned by the automaton and that must outlive it (NULL means no additional thread)
+ * @return cell_automaton_t* a pointer to the instance on the heap, is NULL if something went wrong
+ */
+cell_automaton_t *otomaton_create(size_t width, size_t height, size_t stride, task_pool_t *pool);
+
+/**
+ * @brief Creates an automaton on the heap, as `otomaton_create()` does, with the given capacity instead of the
+ * default one (two buffers, disks of the immediate neighbors only).
  * 
- * @param[in] array the array on which every operation will be applied
- * @param[in] width width, in number of sub-arrays, of the main array
- * @param[in] height height, in number of elements of a sub-array
- * @param[in] stride size in bytes of an element of a sub-array
+ * @param[in] width width, in number of elements of a row
+ * @param[in] height height, in number of rows
+ * @param[in] stride size in bytes of an element
+ * @param[in] capacity what the automaton must be able to do, NULL for the default capacity
+ * @param[in] pool pool running the bands of rows of each iteration, not owned by the automaton and that must outlive it (NULL means no additional thread)
  * @return cell_automaton_t* a pointer to the instance on the heap, is NULL if something went wrong
  */
-cell_automaton_t *otomaton_create(void **array, size_t width, size_t height, size_t stride);
+cell_automaton_t *otomaton_create_with(size_t width, size_t height, size_t stride, const otomaton_capacity_t *capacity, task_pool_t *pool);
+
+/**
+ * @brief Changes the order in which the automaton visits the cells of its array. The sequential and frontier
+ * options keep their own order.
+ * 
+ * @param[inout] automaton target automaton, can be NULL (in this case, nothing will be done)
+ * @param[in] traversal new traversal order
+ */
+void otomaton_set_traversal(cell_automaton_t *automaton, otomaton_traversal_t traversal);
+
+/**
+ * @brief Gives the automaton a time after which its applications stop iterating, as soon as the iteration in
+ * progress is over. Each application still goes through at least one iteration. Time blocks, and bands of rows
+ * going through all their iterations at once, are not used while a deadline is set.
+ * 
+ * @param[inout] automaton target automaton, can be NULL (in this case, nothing will be done)
+ * @param[in] deadline time on the clock of `otomaton_now()`, in milliseconds, 0 to iterate without a deadline (the default)
+ */
+void otomaton_set_deadline(cell_automaton_t *automaton, f64 deadline);
+
+/**
+ * @brief Returns the current time of the monotonic clock the deadlines of the automaton are measured with.
+ * 
+ * @return f64 time elapsed since an arbitrary point, in milliseconds
+ */
+f64 otomaton_now(void);
+
+/**
+ * @brief Builds the mask of the cells visited when the mask option is given, from the current state of the array.
+ * The mask is kept as runs of consecutive cells of each row, so the cells left out cost nothing. It is not updated
+ * when the array changes : it must be built again once the cells it was built from change.
+ * 
+ * @param[inout] automaton target automaton, can be NULL (in this case, nothing will be done)
+ * @param[in] predicate tells if a cell is in the mask, NULL to remove the mask (every cell is then visited)
+ * @return u32 1 if the mask was built, 0 otherwise (the automaton is then left without a mask)
+ */
+u32 otomaton_set_mask(cell_automaton_t *automaton, cell_predicate_func_t predicate);
+
+/**
+ * @brief Returns the array currently held by the automaton, stored row after row. It can be freely modified
+ * between two applications of the automaton.
+ * 
+ * @param[in] automaton target automaton
+ * @param[out] out_pitch distance in bytes between the starts of two consecutive rows, can be NULL
+ * @return void* first element of the array, NULL if the automaton is NULL
+ */
+void *otomaton_array(cell_automaton_t *automaton, size_t *out_pitch);
 
 /**
  * @brief Destroys an automaton and releases the resources taken by the instance. 
@@ -56,4 +332,29 @@ cell_automaton_t *otomaton_create(void **array, size_t width, size_t height, siz
  */
 void otomaton_destroy(cell_automaton_t **automaton);
 
+/**
+ * @brief Changes the dimensions of an automaton's array, keeping its settings and its pool. The array's
+ * content is left uninitialized and any mask is dropped. The automaton's block is reused if it
+ * is large enough, otherwise the automaton moves to a larger one and the pointed pointer is updated.
+ * 
+ * @param[inout] automaton automaton to resize
+ * @param[in] width new width, in number of elements of a row
+ * @param[in] height new height, in number of rows
+ * @return u32 1 if the automaton was resized, 0 if there was not enough memory and it was left as it was
+ */
+u32 otomaton_resize(cell_automaton_t **automaton, size_t width, size_t height);
+
+/**
+ * @brief Returns the size of the single block an automaton of the given dimensions is created in, so it can be
+ * checked against what the system can give before creating it.
+ * 
+ * @param[in] width width, in number of elements of a row
+ * @param[in] height height, in number of rows
+ * @param[in] stride size in bytes of an element
+ * @param[in] capacity what the automaton would be able to do, NULL for the default capacity
+ * @param[in] pool pool the automaton would run its bands on, can be NULL
+ * @return size_t size of the block, in bytes
+ */
+size_t otomaton_footprint(size_t width, size_t height, size_t stride, const otomaton_capacity_t *capacity, task_pool_t *pool);
+
 #endif
@@ -14,6 +14,7 @@
 #include <unstandard.h>
 
 #define HEXAGON_SIDES_NB (6u)     ///< number of sides of an hexagon. tough.
+#define HEXA_PACKED_DIRECTIONS_NB (32u) ///< directions a plate's angle can take in a packed cell, as many as the telluric vectors'
 
 /**
  * @brief Possible directions from a hexagonal cell to another. Ordered along the unit circle.
@@ -101,6 +102,15 @@ typedef u16 frwtr_m_t;
 /// @brief ratio type (usually between 0.0f and 1.0f, but no guarantee)
 typedef f32 ratio_t;
 
+/// @brief ratio between 0.0f and 1.0f in fixed point, 0xFFFF being 1.0f
+typedef u16 ratio16_t;
+
+/// @brief ratio between 0.0f and 1.0f in fixed point, 0xFF being 1.0f
+typedef u8 ratio8_t;
+
+/// @brief angle in fixed point, as a fraction of a whole turn
+typedef u16 angle16_t;
+
 /**
  * @brief A single hexagonal cell.
  */
@@ -135,6 +145,69 @@ typedef struct hexa_cell_t {
     flag_set8_t freshwater_sources_directions;
 } hexa_cell_t;
 
+/**
+ * @brief Fields of a cell, so the code working on cells can declare which ones it touches.
+ */
+typedef enum hexa_cell_field_t {
+    HEXAW_FIELD_TELLURIC_VECTOR,                ///< `telluric_vector`
+    HEXAW_FIELD_WINDS_VECTOR,                   ///< `winds_vector`
+    HEXAW_FIELD_FRESHWATER_DIRECTION,           ///< `freshwater_direction`
+    HEXAW_FIELD_CLOUD_COVER,                    ///< `cloud_cover`
+    HEXAW_FIELD_PRECIPITATIONS,                 ///< `precipitations`
+    HEXAW_FIELD_VEGETATION_COVER,               ///< `vegetation_cover`
+    HEXAW_FIELD_VEGETATION_TREES,               ///< `vegetation_trees`
+    HEXAW_FIELD_FLAGS,                          ///< `flags`
+    HEXAW_FIELD_FRESHWATER_HEIGHT,              ///< `freshwater_height`
+    HEXAW_FIELD_ALTITUDE,                       ///< `altitude`
+    HEXAW_FIELD_TEMPERATURE,                    ///< `temperature`
+    HEXAW_FIELD_FRESHWATER_SOURCES_DIRECTIONS,  ///< `freshwater_sources_directions`
+
+    HEXAW_FIELDS_NB,    ///< Total number of fields
+} hexa_cell_field_t;
+
+/// builds a set of fields from a single field
+#define HEXAW_FIELD(_f) ((flag_set32_t) (0x01 << (_f)))
+
+/**
+ * @brief A single hexagonal cell stored in 20 bytes instead of the 48 of `hexa_cell_t`, for the worlds kept once
+ * generated. The ratios and the winds are stored in fixed point, and the directions are packed together. The
+ * telluric vectors, the directions and all the integer fields are kept exactly. Worlds are only packed once
+ * generated, the layers reading and writing `hexa_cell_t`.
+ */
+typedef struct hexa_cell_packed_t {
+    /// unsigned integer containing the flags as bit offsets
+    flag_set32_t flags;
+    /// mean altitude of the tile
+    alt_m_t altitude;
+    /// freshwater excess height
+    frwtr_m_t freshwater_height;
+
+    /// mean humidty on the tile
+    ratio16_t cloud_cover;
+    /// mean precipitations on the tile
+    ratio16_t precipitations;
+    /// mean wind direction
+    angle16_t winds_angle;
+
+    /// direction of the tectonic plate, out of `HEXA_PACKED_DIRECTIONS_NB`
+    u16 telluric_direction : 5;
+    /// 1 if the tile belongs to a tectonic plate (the telluric vector has a magnitude), 0 otherwise
+    u16 telluric_is_set : 1;
+    /// freshwater direction on the tile, as a `cell_direction_t`
+    u16 freshwater_direction : 3;
+    /// bit flags representing wether a direction is considered as a freshwater source
+    u16 freshwater_sources_directions : 6;
+
+    /// mean wind force
+    ratio8_t winds_magnitude;
+    // vegetation coefficients
+    ratio8_t vegetation_cover;
+    ratio8_t vegetation_trees;
+
+    /// expected temperature of the tile
+    temp_c_t temperature;
+} hexa_cell_packed_t;
+
 /**
  * @brief just the shape of an hexagon.
  */
@@ -199,6 +272,15 @@ void hexa_cell_get_surrounding_cells_pointed(f32 angle, size_t *out_pointed_cell
  */
 void hexa_cell_direction_of_surrounding_angles(hexa_cell_t **angles_around, void *angle_field_offset, f32 *out_angles);
 
+/**
+ * @brief Locates a field inside a cell.
+ * 
+ * @param[in] field target field
+ * @param[out] out_offset offset of the field from the start of the cell, in bytes
+ * @param[out] out_size size of the field, in bytes
+ */
+void hexa_cell_field_span(hexa_cell_field_t field, size_t *out_offset, size_t *out_size);
+
 /**
  * @brief Sets an bit flag in a cell.
  * 
@@ -216,4 +298,69 @@ void hexa_cell_set_flag(hexa_cell_t *cell, u32 flag);
  */
 u32 hexa_cell_has_flag(hexa_cell_t *cell, u32 flag);
 
+/**
+ * @brief Stores a cell in its packed form. Ratios outside of 0.0f and 1.0f are clamped.
+ * 
+ * @param[in] cell packed cell
+ * @param[out] out_packed outgoing packed cell
+ */
+void hexa_cell_pack(const hexa_cell_t *cell, hexa_cell_packed_t *out_packed);
+
+/**
+ * @brief Gets a cell back from its packed form. The angles of the winds come back between 0 and 2 pi.
+ * 
+ * @param[in] packed packed cell
+ * @param[out] out_cell outgoing cell
+ */
+void hexa_cell_unpack(const hexa_cell_packed_t *packed, hexa_cell_t *out_cell);
+
+/**
+ * @brief Converts a ratio to 16 bits of fixed point, rounded to the nearest value and clamped between 0.0f and 1.0f.
+ * 
+ * @param[in] ratio converted ratio
+ * @return ratio16_t ratio in fixed point
+ */
+ratio16_t ratio_to_fixed16(ratio_t ratio);
+
+/**
+ * @brief Converts a ratio from 16 bits of fixed point.
+ * 
+ * @param[in] fixed ratio in fixed point
+ * @return ratio_t converted ratio
+ */
+ratio_t ratio_from_fixed16(ratio16_t fixed);
+
+/**
+ * @brief Converts a ratio to 8 bits of fixed point, rounded to the nearest value and clamped between 0.0f and 1.0f.
+ * 
+ * @param[in] ratio converted ratio
+ * @return ratio8_t ratio in fixed point
+ */
+ratio8_t ratio_to_fixed8(ratio_t ratio);
+
+/**
+ * @brief Converts a ratio from 8 bits of fixed point.
+ * 
+ * @param[in] fixed ratio in fixed point
+ * @return ratio_t converted ratio
+ */
+ratio_t ratio_from_fixed8(ratio8_t fixed);
+
+/**
+ * @brief Converts an angle in radians to a fraction of a whole turn in fixed point, rounded to the nearest value.
+ * Any angle is accepted, the whole turns being removed.
+ * 
+ * @param[in] angle converted angle, in radians
+ * @return angle16_t angle in fixed point
+ */
+angle16_t angle_to_fixed16(f32 angle);
+
+/**
+ * @brief Converts an angle from a fraction of a whole turn in fixed point.
+ * 
+ * @param[in] fixed angle in fixed point
+ * @return f32 converted angle, in radians between 0 and 2 pi
+ */
+f32 angle_from_fixed16(angle16_t fixed);
+
 #endif
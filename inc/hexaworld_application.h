@@ -35,9 +35,13 @@ void hexaworld_raylib_app_deinit(hexaworld_raylib_app_handle_t **hexapp);
  * @param[in] window_height height of the raylib window, in pixels
  * @param[in] world_width width of the world, in number of tiles
  * @param[in] world_height height of the world, in number of tiles
+ * @param[in] thread_nb number of threads used to generate the world
+ * @param[in] coarse_levels number of coarser worlds the layers are first generated on (see `hexaworld_set_coarse_levels()`)
+ * @param[in] generation_budget time each generation of the world should take, in milliseconds, 0 for no limit (see `hexaworld_generate()`)
+ * @param[in] storage form each generated world is kept in until the next one (see `hexaworld_storage_t`), 0 to keep it dense as it was generated
  * @return hexaworld_raylib_app_handle_t* a handle to the application service data
  */
-hexaworld_raylib_app_handle_t * hexaworld_raylib_app_init(i32 random_seed, u32 window_width, u32 window_height, u32 world_width, u32 world_height);
+hexaworld_raylib_app_handle_t * hexaworld_raylib_app_init(i32 random_seed, u32 window_width, u32 window_height, u32 world_width, u32 world_height, u32 thread_nb, u32 coarse_levels, f64 generation_budget, u32 storage);
 
 /**
  * @brief Runs the application until the window is closed. 
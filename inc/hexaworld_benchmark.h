@@ -0,0 +1,33 @@
+/**
+ * @file hexaworld_benchmark.h
+ * @author gabriel 
+ * @brief Measures the time taken to generate an hexa-tiled world, without any window.
+ * @version 0.1
+ * @date 2023-04-24
+ * 
+ * @copyright Copyright (c) 2023
+ * 
+ */
+#ifndef __HEXAWORLD_BENCHMARK_H__
+#define __HEXAWORLD_BENCHMARK_H__
+
+#include <unstandard.h>
+
+/**
+ * @brief Generates the same world once with each of the automaton's traversal orders, and prints on the standard
+ * output the time taken by each layer, in milliseconds. With coarser worlds, given or added to fit in the budget, the
+ * world is generated once more at its full size and the mean temperatures and winds of each band of rows are compared
+ * between both. The neighborhood kernels of the automaton are also timed on the world's altitudes, and checked against
+ * the same computations done tile by tile.
+ * 
+ * @param[in] random_seed any intgerer that will be used to seed the random number generator.
+ * @param[in] world_width width of the world, in number of tiles
+ * @param[in] world_height height of the world, in number of tiles
+ * @param[in] thread_nb number of threads used to generate the world
+ * @param[in] coarse_levels number of coarser worlds the layers are first generated on (see `hexaworld_set_coarse_levels()`)
+ * @param[in] generation_budget if not 0, the world is generated once more within this time, in milliseconds, and what was given up to fit in it is printed (see `hexaworld_generate()`)
+ * @return u32 0 if a kernel differs from its tile by tile computation, or if the coarser worlds led to a climate far from the one of the full-size world without any layer cut short by the budget, 1 otherwise
+ */
+u32 hexaworld_benchmark(i32 random_seed, u32 world_width, u32 world_height, u32 thread_nb, u32 coarse_levels, f64 generation_budget);
+
+#endif
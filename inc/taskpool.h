@@ -0,0 +1,85 @@
+/**
+ * @file taskpool.h
+ * @author gabriel 
+ * @brief Small work-stealing task runtime over pthreads.
+ * Each thread of the pool owns a queue of tasks : it runs the last task it submitted first, and steals the oldest
+ * task of another queue when its own is empty. Threads outside the pool share an additional queue. A thread waiting
+ * for some tasks to end runs tasks in the meantime, so tasks can submit and wait for other tasks without
+ * blocking the pool, and a single pool can be shared by everything running in parallel without spawning more
+ * threads than there are cores.
+ * @version 0.1
+ * @date 2023-04-23
+ * 
+ * @copyright Copyright (c) 2023
+ * 
+ */
+#ifndef __TASKPOOL_H__
+#define __TASKPOOL_H__
+
+#include <unstandard.h>
+
+/**
+ * @brief Opaque type to a pool of threads running tasks.
+ */
+typedef struct task_pool_t task_pool_t;
+
+/**
+ * @brief Type of a function pointer run as a task.
+ * @param[inout] argument whatever the function needs, given when the task was submitted.
+ */
+typedef void (*task_func_t)(void *argument);
+
+/**
+ * @brief Set of tasks waited for together. Must be zero-initialized before the first submission, and can be
+ * reused once waited for.
+ */
+typedef struct task_group_t {
+    /// number of tasks of the group that are not done yet
+    size_t pending_nb;
+} task_group_t;
+
+/**
+ * @brief Creates a pool of threads on the heap and returns a pointer to it.
+ * If some threads cannot be created, the tasks are split between those that could be.
+ * 
+ * @param[in] thread_nb number of threads running the tasks, the calling thread included (0 and 1 both mean no additional thread)
+ * @return task_pool_t* a pointer to the instance on the heap, is NULL if something went wrong
+ */
+task_pool_t *taskpool_create(size_t thread_nb);
+
+/**
+ * @brief Returns the number of threads running the tasks of a pool, the thread waiting for them included.
+ * 
+ * @param[in] pool target pool, can be NULL
+ * @return size_t number of threads, 1 if the pool is NULL
+ */
+size_t taskpool_thread_nb(task_pool_t *pool);
+
+/**
+ * @brief Submits a task to a pool. The task might start right away on another thread, and is sure to be done
+ * once its group has been waited for.
+ * 
+ * @param[inout] pool target pool, if NULL the task is run right away by the calling thread
+ * @param[inout] group group of the task
+ * @param[in] function function run by the task
+ * @param[in] argument argument given to the function
+ */
+void taskpool_submit(task_pool_t *pool, task_group_t *group, task_func_t function, void *argument);
+
+/**
+ * @brief Runs the tasks of a pool until all the tasks of a group are done.
+ * 
+ * @param[inout] pool target pool, can be NULL
+ * @param[inout] group waited-for group
+ */
+void taskpool_wait(task_pool_t *pool, task_group_t *group);
+
+/**
+ * @brief Stops and joins the threads of a pool, deallocates it, and sets the pointer to NULL.
+ * All the submitted tasks must have been waited for.
+ * 
+ * @param[inout] pool double pointer to a pool
+ */
+void taskpool_destroy(task_pool_t **pool);
+
+#endif
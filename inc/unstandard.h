@@ -60,8 +60,8 @@ typedef struct vector_2d_polar_t {
 } vector_2d_polar_t;
 
 /**
- * @brief Copies byte to byte from `source` to `dest`.
- * The size of `source` and `dest` must both be of at least `nb_bytes`, and `source` must be after `dest` if the two regions overlap.
+ * @brief Copies `nb_bytes` bytes from `source` to `dest`, as if the bytes were copied one by one.
+ * The size of `source` and `dest` must both be of at least `nb_bytes`. The two regions may overlap.
  * 
  * @param[out] dest pointer to the start of the copied-on region
  * @param[in] source pointer to the start of the copied-from region
@@ -12,6 +12,7 @@
 
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include <raylib.h>
 
 #include <cellotomaton.h>
@@ -19,6 +20,14 @@
 
 #include "worldcomponents/hexaworldcomponents.h"
 
+// -------------------------------------------------------------------------------------------------
+// ---- FILE CONSTANTS -----------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/// capacity of a world's automaton : the layers use the frontier and the land mask, carved with everything else so
+/// they are counted in the world's footprint and cannot fail once the generation started
+static const otomaton_capacity_t hexaworld_automaton_capacity = { .has_frontier = 1u, .has_mask = 1u };
+
 // -------------------------------------------------------------------------------------------------
 // ---- STATIC FUNCTIONS DECLARATIONS --------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -31,12 +40,132 @@
  */
 static void hexaworld_draw_grid(hexaworld_t *world, f32 rectangle_target[4u]);
 
+/**
+ * @brief Points the world's tiles to the array currently held by its automaton.
+ * 
+ * @param[inout] world non-NULL pointer to some world data with a valid automaton
+ */
+static void hexaworld_fetch_tiles(hexaworld_t *world);
+
+/**
+ * @brief Brings back the automaton of a settled world, its tiles going back to the dense form.
+ * 
+ * @param[inout] world non-NULL pointer to some world data
+ * @param[in] keeps_tiles 1 to fill the automaton with the stored tiles and rebuild the land mask from them, 0 to blank them
+ * @return u32 1 if the world is in the dense form, 0 if its automaton could not be allocated and it was left as it was
+ */
+static u32 hexaworld_unsettle(hexaworld_t *world, u32 keeps_tiles);
+
+/**
+ * @brief Gives back the tiles a world keeps out of its automaton, leaving it in the dense form.
+ * 
+ * @param[inout] world non-NULL pointer to some world data
+ */
+static void hexaworld_release_storage(hexaworld_t *world);
+
+/**
+ * @brief Tells if a tile is above the sea level, used to build the mask of the layers only changing the land.
+ * 
+ * @param[in] tile tested tile
+ * @return u32 1 if the tile is land, 0 if it is ocean
+ */
+static u32 hexaworld_tile_is_land(const void *tile);
+
+/**
+ * @brief Copies the fields written by a layer from the world's coarser world, each tile taking the values of the
+ * coarse tile covering it. The flags are left to the layer's flag function, run at the world's size.
+ * 
+ * @param[inout] world non-NULL pointer to some world data with a coarser world where the layer was just generated
+ * @param[in] layer upsampled layer
+ */
+static void hexaworld_upsample(hexaworld_t *world, hexaworld_layer_t layer);
+
+/**
+ * @brief Returns the number of iterations a layer goes through on a world without a deadline, fewer once it is
+ * upsampled from a coarser world.
+ * 
+ * @param[in] world non-NULL pointer to some world data
+ * @param[in] layer generated layer
+ * @return size_t number of iterations given to the automaton
+ */
+static size_t hexaworld_layer_iterations(const hexaworld_t *world, hexaworld_layer_t layer);
+
+/**
+ * @brief Returns the number of coarser worlds under a world.
+ * 
+ * @param[in] world non-NULL pointer to some world data
+ * @return u32 number of coarser worlds
+ */
+static u32 hexaworld_coarse_levels_nb(const hexaworld_t *world);
+
+/**
+ * @brief Predicts the time each layer will take to be generated on a world with some coarser worlds under it, from
+ * the time the layers took the last time they were generated on the world. If a layer was never generated, the
+ * layers are only given weights from their number of iterations.
+ * 
+ * @param[in] world non-NULL pointer to some world data
+ * @param[in] levels_nb number of coarser worlds the layers are generated on
+ * @param[out] predictions time, in milliseconds, or weight of each layer
+ * @return f64 predicted time of the whole generation in milliseconds, 0 if it cannot be predicted
+ */
+static f64 hexaworld_predict_generation(const hexaworld_t *world, u32 levels_nb, f64 predictions[HEXAW_LAYERS_NUMBER]);
+
+/**
+ * @brief Predicts the shortest time the generation of a world with some coarser worlds under it can take, however
+ * short its budget : every layer is still seeded or upsampled and flagged at each size, and goes through an iteration
+ * on the coarsest world.
+ * 
+ * @param[in] world non-NULL pointer to some world data
+ * @param[in] levels_nb number of coarser worlds the layers are generated on
+ * @return f64 predicted time in milliseconds, 0 if it cannot be predicted
+ */
+static f64 hexaworld_predict_floor(const hexaworld_t *world, u32 levels_nb);
+
+/**
+ * @brief Packs the tiles of a world in the dense form, beside its automaton.
+ * 
+ * @param[inout] world non-NULL pointer to some world data in the dense form
+ * @return u32 1 if the packed tiles were stored, 0 if they could not be allocated
+ */
+static u32 hexaworld_store_packed(hexaworld_t *world);
+
+/**
+ * @brief Stores the tiles of a world in the dense form in square blocks, beside its automaton. The ocean tiles and
+ * the land tiles of each block are two groups, each storing once the fields all its tiles share and for each tile
+ * only the fields that differ.
+ * 
+ * @param[inout] world non-NULL pointer to some world data in the dense form
+ * @return u32 1 if the sparse tiles were stored, 0 if they could not be allocated
+ */
+static u32 hexaworld_store_sparse(hexaworld_t *world);
+
+/**
+ * @brief Splits the tiles of a block of a world in the dense form between the ocean and land groups, and finds the
+ * fields each group shares.
+ * 
+ * @param[in] world non-NULL pointer to some world data in the dense form
+ * @param[in] block_x x coordinate of the block, in number of blocks
+ * @param[in] block_y y coordinate of the block, in number of blocks
+ * @param[out] block outgoing block, its groups' records left to be placed
+ */
+static void hexaworld_sparse_classify(const hexaworld_t *world, size_t block_x, size_t block_y, sparse_block_t *block);
+
+/**
+ * @brief Reads a tile of a world settled in the sparse form, from its group's shared fields and its own record.
+ * 
+ * @param[in] world non-NULL pointer to some world data in the sparse form
+ * @param[in] x x coordinate of the tile
+ * @param[in] y y coordinate of the tile
+ * @return hexa_cell_t copy of the tile
+ */
+static hexa_cell_t hexaworld_sparse_tile(const hexaworld_t *world, size_t x, size_t y);
+
 // -------------------------------------------------------------------------------------------------
 // ---- HEADER FUNCTIONS DEFINITIONS ---------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 
 // -------------------------------------------------------------------------------------------------
-hexaworld_t *hexaworld_create_empty(size_t width, size_t height, i32 random_seed) {
+hexaworld_t *hexaworld_create_empty(size_t width, size_t height, i32 random_seed, task_pool_t *pool) {
     hexaworld_t *world = NULL;
 
     // overall data structure
@@ -45,28 +174,24 @@ hexaworld_t *hexaworld_create_empty(size_t width, size_t height, i32 random_seed
         return NULL;
     }
 
-    // tiles columns
-    world->tiles = malloc(sizeof(*world->tiles) * width);
-    if (!world->tiles) {
+    // cell automaton, holding the tiles row after row
+    world->automaton = otomaton_create_with(width, height, sizeof(*(world->tiles)), &hexaworld_automaton_capacity, pool);
+    if (!world->automaton) {
+        free(world);
         return NULL;
     }
+    world->storage = HEXAW_STORAGE_DENSE;
+    world->packed_tiles = NULL;
+    world->sparse = NULL;
+    world->examined_tile = (hexa_cell_t) { 0u };
+    world->traversal = OTOMATON_TRAVERSAL_ROWS;
+    hexaworld_fetch_tiles(world);
 
-    // tiles
-    for (size_t i = 0u ; i < width; i++) {
-        world->tiles[i] = malloc(sizeof(*world->tiles[i]) * height);
-        if (!world->tiles[i]) {
-            return NULL;
-        }
-        for (size_t j = 0u ; j < height ; j++) {
-            world->tiles[i][j] = (hexa_cell_t) { 0u };
+    for (size_t y = 0u ; y < height; y++) {
+        for (size_t x = 0u ; x < width ; x++) {
+            *HEXAW_TILE(world, x, y) = (hexa_cell_t) { 0u };
         }
     }
-    
-    // cell automaton
-    world->automaton = otomaton_create((void **) world->tiles, width, height, sizeof(**(world->tiles)));
-    if (!world->automaton) {
-        return NULL;
-    }
 
     // adding the tectonic plates layer
     world->hexaworld_layers_functions[HEXAW_LAYER_TELLURIC]    = telluric_layer_calls;
@@ -91,26 +216,35 @@ hexaworld_t *hexaworld_create_empty(size_t width, size_t height, i32 random_seed
     world->height = height;
     world->map_seed = random_seed;
 
+    world->pool = pool;
+    world->coarser = NULL;
+
+    for (size_t i = 0u ; i < HEXAW_LAYERS_NUMBER ; i++) {
+        world->layer_costs[i] = 0.0;
+        world->layer_pass_costs[i] = 0.0;
+        world->layer_iterations[i] = 0u;
+    }
+
     return world;
 }
 
+// -------------------------------------------------------------------------------------------------
+size_t hexaworld_footprint(size_t width, size_t height, task_pool_t *pool) {
+    return sizeof(hexaworld_t) + otomaton_footprint(width, height, sizeof(hexa_cell_t), &hexaworld_automaton_capacity, pool);
+}
+
 // -------------------------------------------------------------------------------------------------
 void hexaworld_destroy(hexaworld_t **world) {
 
     if (*world) {
-        if ((*world)->tiles) {
-            for (size_t i = 0u ; i < (*world)->width; i++) {
-                if ((*world)->tiles[i]) {
-                    free((*world)->tiles[i]);
-                }
-            }
-            free((*world)->tiles);
-        }
-
+        hexaworld_destroy(&((*world)->coarser));
         otomaton_destroy(&((*world)->automaton));
+        hexaworld_release_storage(*world);
+        (*world)->tiles = NULL;
 
         (*world)->width = 0u;
         (*world)->height = 0u;
+        (*world)->row_pitch = 0u;
 
         free((*world));
     }
@@ -122,6 +256,7 @@ void hexaworld_destroy(hexaworld_t **world) {
 void hexaworld_draw(hexaworld_t *world, hexaworld_layer_t layer, f32 rectangle_target[4u]) {
     layer_draw_function_t layer_function = NULL;
     hexagon_shape_t shape = { 0u };
+    hexa_cell_t tile = { 0u };
 
     layer_function = world->hexaworld_layers_functions[layer].draw_func;
 
@@ -132,7 +267,8 @@ void hexaworld_draw(hexaworld_t *world, hexaworld_layer_t layer, f32 rectangle_t
         for (size_t y = 0u ; y < world->height ; y++) {
             shape = hexagon_pixel_position_in_rectangle(rectangle_target, x, y, world->width, world->height);
             draw_hexagon(&shape, COLOR_WHITE, 1.0f, DRAW_HEXAGON_FILL);
-            layer_function(world->tiles[x] + y, &shape);
+            tile = hexaworld_tile(world, x, y);
+            layer_function(&tile, &shape);
         }
     }
 
@@ -140,34 +276,171 @@ void hexaworld_draw(hexaworld_t *world, hexaworld_layer_t layer, f32 rectangle_t
 }
 
 // -------------------------------------------------------------------------------------------------
-void hexaworld_genlayer(hexaworld_t *world, hexaworld_layer_t layer) {
+u32 hexaworld_genlayer(hexaworld_t *world, hexaworld_layer_t layer) {
+    return hexaworld_genlayer_until(world, layer, 0.0);
+}
+
+// -------------------------------------------------------------------------------------------------
+u32 hexaworld_genlayer_until(hexaworld_t *world, hexaworld_layer_t layer, f64 deadline) {
+    const f64 tiles_nb = (f64) MAX(world->width * world->height, 1u);
     size_t iteration_number = 0u;
+    u32 iterations_done = 0u;
+    u32 is_refined = 0u;
+    f64 start = 0.0;
+    f64 iterations_time = 0.0;
 
+    // contengency : a settled world needs its automaton back
+    if (!hexaworld_unsettle(world, 1u)) {
+        return 0u;
+    }
+
+    // every layer goes down to the coarser world, as the next layers there read it. Layers without iterations are
+    // cheap enough to be seeded again at each size rather than upsampled
+    if (world->coarser) {
+        hexaworld_genlayer_until(world->coarser, layer, deadline);
+    }
+    is_refined = (world->coarser) && (world->hexaworld_layers_functions[layer].automaton_iter > 0u);
+
+    start = otomaton_now();
     srand(world->map_seed ^ layer);
 
-    if (world->hexaworld_layers_functions[layer].seed_func) {
+    if (is_refined) {
+        hexaworld_upsample(world, layer);
+    } else if (world->hexaworld_layers_functions[layer].seed_func) {
         world->hexaworld_layers_functions[layer].seed_func(world);
     }
 
-    iteration_number = world->hexaworld_layers_functions[layer].automaton_iter;
-    if (world->hexaworld_layers_functions[layer].iteration_flavour == LAYER_GEN_ITERATE_RELATIVE) {
-        iteration_number *= (u32) sqrt(powf((f32) world->width, 2.0f) + powf((f32) world->height, 2.0f)) / 10;
+    iteration_number = hexaworld_layer_iterations(world, layer);
+    // what was upsampled is already the layer, if a rougher one
+    if (is_refined && (deadline > 0.0) && (otomaton_now() >= deadline)) {
+        iteration_number = 0u;
     }
+    otomaton_set_deadline(world->automaton, deadline);
+    iterations_time = otomaton_now();
 
-    // applying the overall generation function N times
-    otomaton_apply(world->automaton, iteration_number, world->hexaworld_layers_functions[layer].automaton_func);
+    // applying the overall generation function N times, preferably row by row unless the cells change in place
+    if ((world->hexaworld_layers_functions[layer].automaton_row_func)
+            && !(world->hexaworld_layers_functions[layer].automaton_options & OTOMATON_OPTION(OTOMATON_OPTION_IN_PLACE))) {
+        iterations_done = otomaton_apply_rows(
+                world->automaton,
+                iteration_number,
+                world->hexaworld_layers_functions[layer].automaton_row_func,
+                world->hexaworld_layers_functions[layer].automaton_options,
+                world->hexaworld_layers_functions[layer].automaton_tolerance);
+    } else {
+        iterations_done = otomaton_apply(
+                world->automaton,
+                iteration_number,
+                world->hexaworld_layers_functions[layer].automaton_func,
+                world->hexaworld_layers_functions[layer].automaton_options,
+                world->hexaworld_layers_functions[layer].automaton_tolerance);
+    }
+    otomaton_set_deadline(world->automaton, 0.0);
+    iterations_time = otomaton_now() - iterations_time;
 
     // if the flag gneration function exists, apply it one time
     if (world->hexaworld_layers_functions[layer].flag_gen_func) {
-        otomaton_apply(world->automaton, 1u, world->hexaworld_layers_functions[layer].flag_gen_func);
+        otomaton_apply(world->automaton, 1u, world->hexaworld_layers_functions[layer].flag_gen_func, world->hexaworld_layers_functions[layer].flag_gen_options, 0.0f);
+    }
+
+    // the automaton swapped its buffers instead of copying them back
+    hexaworld_fetch_tiles(world);
+
+    // the next layers given the mask option only visit the land, as it is now
+    if (world->hexaworld_layers_functions[layer].fields_written & HEXAW_FIELD(HEXAW_FIELD_ALTITUDE)) {
+        otomaton_set_mask(world->automaton, &hexaworld_tile_is_land);
+    }
+
+    // the iterations apart from the passes around them, which are gone through whatever the deadline
+    world->layer_pass_costs[layer] = ((otomaton_now() - start) - iterations_time) / tiles_nb;
+    if (iterations_done > 0u) {
+        world->layer_costs[layer] = iterations_time / (tiles_nb * (f64) iterations_done);
+    }
+    if (!is_refined) {
+        world->layer_iterations[layer] = iterations_done;
+    }
+
+    return iterations_done;
+}
+
+// -------------------------------------------------------------------------------------------------
+void hexaworld_generate(hexaworld_t *world, f64 budget, hexaworld_generation_report_t *report) {
+    hexaworld_generation_report_t ignored_report = { 0u };
+    f64 predictions[HEXAW_LAYERS_NUMBER] = { 0u };
+    f64 remaining_weight = 0.0;
+    f64 start = otomaton_now();
+    f64 deadline = 0.0;
+    f64 layer_deadline = 0.0;
+    u32 initial_levels_nb = 0u;
+    u32 levels_nb = 0u;
+
+    if (!report) {
+        report = &ignored_report;
+    }
+    *report = (hexaworld_generation_report_t) { 0u };
+
+    initial_levels_nb = hexaworld_coarse_levels_nb(world);
+    levels_nb = initial_levels_nb;
+
+    // coarser worlds are added until the generation is predicted to fit, or the worlds become too small
+    if (budget > 0.0) {
+        deadline = start + budget;
+        while ((hexaworld_predict_generation(world, levels_nb, predictions) > budget)
+                && (hexaworld_set_coarse_levels(world, levels_nb + 1u) > levels_nb)) {
+            levels_nb += 1u;
+        }
+    }
+    hexaworld_predict_generation(world, levels_nb, predictions);
+    report->predicted_floor = hexaworld_predict_floor(world, levels_nb);
+
+    hexaworld_raze(world);
+
+    for (size_t layer = 0u ; layer < HEXAW_LAYERS_NUMBER ; layer++) {
+        // each layer gets its share of what is left, so the time saved by a layer goes to the next ones
+        if (budget > 0.0) {
+            remaining_weight = 0.0;
+            for (size_t i = layer ; i < HEXAW_LAYERS_NUMBER ; i++) {
+                remaining_weight += predictions[i];
+            }
+            layer_deadline = otomaton_now();
+            if (remaining_weight > 0.0) {
+                layer_deadline += MAX(deadline - layer_deadline, 0.0) * (predictions[layer] / remaining_weight);
+            }
+        }
+
+        report->iterations_wanted[layer] = (u32) hexaworld_layer_iterations(world, (hexaworld_layer_t) layer);
+        report->iterations_done[layer] = hexaworld_genlayer_until(world, (hexaworld_layer_t) layer, layer_deadline);
+
+        // a layer converging earlier than its count is not degraded
+        if ((budget > 0.0) && (report->iterations_done[layer] < report->iterations_wanted[layer]) && (otomaton_now() >= layer_deadline)) {
+            report->degraded_layers |= ((flag_set32_t) 1u << layer);
+        }
     }
+
+    report->coarse_levels = levels_nb;
+    report->added_coarse_levels = levels_nb - initial_levels_nb;
+    hexaworld_set_coarse_levels(world, initial_levels_nb);
+
+    report->elapsed = otomaton_now() - start;
+    report->budget_missed = (budget > 0.0) && (report->elapsed > budget);
 }
 
 // -------------------------------------------------------------------------------------------------
 void hexaworld_raze(hexaworld_t *world) {
-    for (size_t x = 0u ; x < world->width ; x++) {
-        for (size_t y = 0u ; y < world->height ; y++) {
-            world->tiles[x][y] = (hexa_cell_t) { 0u };
+    if (world->coarser) {
+        hexaworld_raze(world->coarser);
+    }
+
+    // contengency : a settled world that cannot get its automaton back keeps its tiles
+    if (!hexaworld_unsettle(world, 0u)) {
+        return;
+    }
+
+    otomaton_set_mask(world->automaton, NULL);
+
+    for (size_t y = 0u ; y < world->height ; y++) {
+        for (size_t x = 0u ; x < world->width ; x++) {
+            *HEXAW_TILE(world, x, y) = (hexa_cell_t) { 0u };
         }
     }
 }
@@ -175,6 +448,172 @@ void hexaworld_raze(hexaworld_t *world) {
 // -------------------------------------------------------------------------------------------------
 void hexaworld_reseed(hexaworld_t *world, i32 new_seed) {
     world->map_seed = new_seed;
+
+    if (world->coarser) {
+        hexaworld_reseed(world->coarser, new_seed);
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+u32 hexaworld_resize(hexaworld_t *world, size_t width, size_t height) {
+    u32 levels_nb = 0u;
+
+    if ((world->width != width) || (world->height != height)) {
+        // the automaton keeps its block, buffers and settings if they fit, and is left as it was if nothing does
+        if ((!hexaworld_unsettle(world, 0u)) || (!otomaton_resize(&(world->automaton), width, height))) {
+            return 0u;
+        }
+        hexaworld_fetch_tiles(world);
+        world->width = width;
+        world->height = height;
+
+        // timings were for the old size
+        for (size_t i = 0u ; i < HEXAW_LAYERS_NUMBER ; i++) {
+            world->layer_costs[i] = 0.0;
+            world->layer_pass_costs[i] = 0.0;
+            world->layer_iterations[i] = 0u;
+        }
+
+        // coarser worlds follow, as many as there can still be
+        levels_nb = hexaworld_coarse_levels_nb(world);
+        if ((world->coarser) && (!hexaworld_resize(world->coarser, (width + 1u) / 2u, (height + 1u) / 2u))) {
+            hexaworld_destroy(&(world->coarser));
+        }
+        hexaworld_set_coarse_levels(world, levels_nb);
+    }
+
+    hexaworld_raze(world);
+
+    return 1u;
+}
+
+// -------------------------------------------------------------------------------------------------
+void hexaworld_set_traversal(hexaworld_t *world, otomaton_traversal_t traversal) {
+    world->traversal = traversal;
+    otomaton_set_traversal(world->automaton, traversal);
+
+    if (world->coarser) {
+        hexaworld_set_traversal(world->coarser, traversal);
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+u32 hexaworld_set_coarse_levels(hexaworld_t *world, u32 levels_nb) {
+    size_t coarse_width = (world->width + 1u) / 2u;
+    size_t coarse_height = (world->height + 1u) / 2u;
+
+    if ((levels_nb == 0u) || (coarse_width < COARSE_TO_FINE_MIN_SIDE) || (coarse_height < COARSE_TO_FINE_MIN_SIDE)) {
+        hexaworld_destroy(&(world->coarser));
+        return 0u;
+    }
+
+    if (!world->coarser) {
+        world->coarser = hexaworld_create_empty(coarse_width, coarse_height, world->map_seed, world->pool);
+        // contengency
+        if (!world->coarser) {
+            return 0u;
+        }
+    }
+
+    return 1u + hexaworld_set_coarse_levels(world->coarser, levels_nb - 1u);
+}
+
+// -------------------------------------------------------------------------------------------------
+u32 hexaworld_settle(hexaworld_t *world, hexaworld_storage_t storage) {
+    u32 is_stored = 0u;
+
+    // contengency
+    if (storage >= HEXAW_STORAGES_NB) {
+        return 0u;
+    }
+
+    if (storage == world->storage) {
+        return 1u;
+    }
+
+    // from a stored form to another, the tiles go through the dense form
+    if (!hexaworld_unsettle(world, 1u)) {
+        return 0u;
+    }
+    if (storage == HEXAW_STORAGE_DENSE) {
+        return 1u;
+    }
+
+    switch (storage) {
+        case HEXAW_STORAGE_PACKED:
+            is_stored = hexaworld_store_packed(world);
+            break;
+        case HEXAW_STORAGE_SPARSE:
+            is_stored = hexaworld_store_sparse(world);
+            break;
+        default:
+            break;
+    }
+    if (!is_stored) {
+        return 0u;
+    }
+
+    // only the generation needs the automaton and the coarser worlds
+    otomaton_destroy(&(world->automaton));
+    hexaworld_destroy(&(world->coarser));
+    world->tiles = NULL;
+    world->row_pitch = 0u;
+
+    world->storage = storage;
+
+    return 1u;
+}
+
+// -------------------------------------------------------------------------------------------------
+hexa_cell_t hexaworld_tile(const hexaworld_t *world, size_t x, size_t y) {
+    hexa_cell_t tile = { 0u };
+
+    switch (world->storage) {
+        case HEXAW_STORAGE_PACKED:
+            hexa_cell_unpack(world->packed_tiles + (y * world->width) + x, &tile);
+            break;
+        case HEXAW_STORAGE_SPARSE:
+            tile = hexaworld_sparse_tile(world, x, y);
+            break;
+        default:
+            tile = *HEXAW_TILE(world, x, y);
+            break;
+    }
+
+    return tile;
+}
+
+// -------------------------------------------------------------------------------------------------
+hexaworld_field_view_t hexaworld_field_view(const hexaworld_t *world, hexa_cell_field_t field) {
+    hexaworld_field_view_t view = { 0u };
+    size_t offset = 0u;
+
+    // contengency : the tiles of a settled world are not cells laid out in rows
+    if ((world->storage != HEXAW_STORAGE_DENSE) || (!world->tiles)) {
+        return view;
+    }
+
+    hexa_cell_field_span(field, &offset, &(view.element_size));
+
+    view.base = (const u8 *) world->tiles + offset;
+    view.stride = sizeof(*(world->tiles));
+    view.row_pitch = world->row_pitch * sizeof(*(world->tiles));
+    view.width = world->width;
+    view.height = world->height;
+
+    return view;
+}
+
+// -------------------------------------------------------------------------------------------------
+size_t hexaworld_tiles_footprint(const hexaworld_t *world) {
+    switch (world->storage) {
+        case HEXAW_STORAGE_PACKED:
+            return world->width * world->height * sizeof(*(world->packed_tiles));
+        case HEXAW_STORAGE_SPARSE:
+            return world->sparse->footprint;
+        default:
+            return otomaton_footprint(world->width, world->height, sizeof(hexa_cell_t), &hexaworld_automaton_capacity, world->pool);
+    }
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -198,7 +637,12 @@ hexa_cell_t *hexaworld_tile_at(hexaworld_t *world, u32 x, u32 y, f32 reference_r
     *out_x = wanted_x;
     *out_y = wanted_y;
 
-    return world->tiles[wanted_x] + wanted_y;
+    if (world->storage != HEXAW_STORAGE_DENSE) {
+        world->examined_tile = hexaworld_tile(world, wanted_x, wanted_y);
+        return &(world->examined_tile);
+    }
+
+    return HEXAW_TILE(world, wanted_x, wanted_y);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -220,3 +664,370 @@ static void hexaworld_draw_grid(hexaworld_t *world, f32 rectangle_target[4u]) {
         }
     }
 }
+
+// -------------------------------------------------------------------------------------------------
+static void hexaworld_fetch_tiles(hexaworld_t *world) {
+    size_t pitch = 0u;
+
+    world->tiles = otomaton_array(world->automaton, &pitch);
+    world->row_pitch = pitch / sizeof(*(world->tiles));
+}
+
+// -------------------------------------------------------------------------------------------------
+static u32 hexaworld_unsettle(hexaworld_t *world, u32 keeps_tiles) {
+    if (world->storage == HEXAW_STORAGE_DENSE) {
+        return 1u;
+    }
+
+    world->automaton = otomaton_create_with(world->width, world->height, sizeof(*(world->tiles)), &hexaworld_automaton_capacity, world->pool);
+    // contengency
+    if (!world->automaton) {
+        return 0u;
+    }
+    otomaton_set_traversal(world->automaton, world->traversal);
+    hexaworld_fetch_tiles(world);
+
+    // the tiles are read from where they are stored before it is given back
+    for (size_t y = 0u ; y < world->height ; y++) {
+        for (size_t x = 0u ; x < world->width ; x++) {
+            *HEXAW_TILE(world, x, y) = keeps_tiles ? hexaworld_tile(world, x, y) : (hexa_cell_t) { 0u };
+        }
+    }
+    hexaworld_release_storage(world);
+
+    // the next layers given the mask option only visit the land
+    if (keeps_tiles) {
+        otomaton_set_mask(world->automaton, &hexaworld_tile_is_land);
+    }
+
+    return 1u;
+}
+
+// -------------------------------------------------------------------------------------------------
+static void hexaworld_release_storage(hexaworld_t *world) {
+    free(world->packed_tiles);
+    world->packed_tiles = NULL;
+
+    if (world->sparse) {
+        free(world->sparse->records);
+        free(world->sparse);
+        world->sparse = NULL;
+    }
+
+    world->storage = HEXAW_STORAGE_DENSE;
+}
+
+// -------------------------------------------------------------------------------------------------
+static u32 hexaworld_tile_is_land(const void *tile) {
+    return (((const hexa_cell_t *) tile)->altitude > 0);
+}
+
+// -------------------------------------------------------------------------------------------------
+static void hexaworld_upsample(hexaworld_t *world, hexaworld_layer_t layer) {
+    flag_set32_t fields = world->hexaworld_layers_functions[layer].fields_written;
+    size_t offsets[HEXAW_FIELDS_NB] = { 0u };
+    size_t sizes[HEXAW_FIELDS_NB] = { 0u };
+    size_t spans_nb = 0u;
+    hexa_cell_t *tile = NULL;
+    hexa_cell_t *coarse_tile = NULL;
+
+    // a layer writing whole cells has all its fields upsampled
+    if (!fields) {
+        fields = ~((flag_set32_t) 0u);
+    }
+    fields &= ~HEXAW_FIELD(HEXAW_FIELD_FLAGS);
+
+    for (size_t i = 0u ; i < HEXAW_FIELDS_NB ; i++) {
+        if (fields & HEXAW_FIELD(i)) {
+            hexa_cell_field_span((hexa_cell_field_t) i, offsets + spans_nb, sizes + spans_nb);
+            spans_nb += 1u;
+        }
+    }
+
+    for (size_t y = 0u ; y < world->height ; y++) {
+        for (size_t x = 0u ; x < world->width ; x++) {
+            tile = HEXAW_TILE(world, x, y);
+            coarse_tile = HEXAW_TILE(world->coarser, (x * world->coarser->width) / world->width, (y * world->coarser->height) / world->height);
+
+            for (size_t i = 0u ; i < spans_nb ; i++) {
+                memcpy((u8 *) tile + offsets[i], (u8 *) coarse_tile + offsets[i], sizes[i]);
+            }
+        }
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static size_t hexaworld_layer_iterations(const hexaworld_t *world, hexaworld_layer_t layer) {
+    size_t iteration_number = world->hexaworld_layers_functions[layer].automaton_iter;
+
+    if (world->hexaworld_layers_functions[layer].iteration_flavour == LAYER_GEN_ITERATE_RELATIVE) {
+        iteration_number *= (u32) sqrt(powf((f32) world->width, 2.0f) + powf((f32) world->height, 2.0f)) / 10;
+    }
+
+    if ((world->coarser) && (iteration_number > 0u)) {
+        iteration_number = MIN(iteration_number, COARSE_TO_FINE_REFINEMENT_ITER);
+    }
+
+    return iteration_number;
+}
+
+// -------------------------------------------------------------------------------------------------
+static u32 hexaworld_coarse_levels_nb(const hexaworld_t *world) {
+    u32 levels_nb = 0u;
+
+    while (world->coarser) {
+        world = world->coarser;
+        levels_nb += 1u;
+    }
+
+    return levels_nb;
+}
+
+// -------------------------------------------------------------------------------------------------
+static f64 hexaworld_predict_generation(const hexaworld_t *world, u32 levels_nb, f64 predictions[HEXAW_LAYERS_NUMBER]) {
+    const layer_calls_t *calls = NULL;
+    f64 total = 0.0;
+    f64 iterations = 0.0;
+    f64 width = 0.0;
+    f64 height = 0.0;
+    u32 is_predictable = 1u;
+
+    for (size_t layer = 0u ; layer < HEXAW_LAYERS_NUMBER ; layer++) {
+        calls = world->hexaworld_layers_functions + layer;
+        is_predictable = is_predictable && (world->layer_pass_costs[layer] > 0.0) && ((world->layer_costs[layer] > 0.0) || (calls->automaton_iter == 0u));
+
+        // the last count gone through without coarser worlds, converging layers doing fewer than asked
+        iterations = (f64) world->layer_iterations[layer];
+        if (iterations == 0.0) {
+            iterations = (f64) calls->automaton_iter;
+            if (calls->iteration_flavour == LAYER_GEN_ITERATE_RELATIVE) {
+                iterations *= floor(sqrt(((f64) world->width * (f64) world->width) + ((f64) world->height * (f64) world->height)) / 10.0);
+            }
+        }
+
+        // the tiles of each coarser world go through all the iterations, then are refined in each finer world
+        predictions[layer] = 0.0;
+        width = (f64) world->width;
+        height = (f64) world->height;
+        for (u32 level = 0u ; level <= levels_nb ; level++) {
+            if (level == levels_nb) {
+                predictions[layer] += width * height * ((iterations * world->layer_costs[layer]) + world->layer_pass_costs[layer]);
+                break;
+            }
+            predictions[layer] += width * height * ((MIN(iterations, (f64) COARSE_TO_FINE_REFINEMENT_ITER) * world->layer_costs[layer]) + world->layer_pass_costs[layer]);
+
+            width = ceil(width / 2.0);
+            height = ceil(height / 2.0);
+            if (calls->iteration_flavour == LAYER_GEN_ITERATE_RELATIVE) {
+                iterations = ceil(iterations / 2.0);
+            }
+        }
+
+        total += predictions[layer];
+    }
+
+    if (is_predictable) {
+        return total;
+    }
+
+    // without any measure, the layers are only weighted by their passes over the tiles
+    for (size_t layer = 0u ; layer < HEXAW_LAYERS_NUMBER ; layer++) {
+        predictions[layer] = (f64) world->hexaworld_layers_functions[layer].automaton_iter + 2.0;
+    }
+
+    return 0.0;
+}
+
+// -------------------------------------------------------------------------------------------------
+static f64 hexaworld_predict_floor(const hexaworld_t *world, u32 levels_nb) {
+    f64 total = 0.0;
+    f64 width = 0.0;
+    f64 height = 0.0;
+
+    for (size_t layer = 0u ; layer < HEXAW_LAYERS_NUMBER ; layer++) {
+        if (world->layer_pass_costs[layer] <= 0.0) {
+            return 0.0;
+        }
+
+        // past the deadline, only the coarsest world still goes through an iteration
+        width = (f64) world->width;
+        height = (f64) world->height;
+        for (u32 level = 0u ; level <= levels_nb ; level++) {
+            total += width * height * world->layer_pass_costs[layer];
+            if ((level == levels_nb) && (world->hexaworld_layers_functions[layer].automaton_iter > 0u)) {
+                total += width * height * world->layer_costs[layer];
+            }
+            width = ceil(width / 2.0);
+            height = ceil(height / 2.0);
+        }
+    }
+
+    return total;
+}
+
+// -------------------------------------------------------------------------------------------------
+static u32 hexaworld_store_packed(hexaworld_t *world) {
+    world->packed_tiles = malloc(MAX(world->width * world->height, 1u) * sizeof(*(world->packed_tiles)));
+    if (!world->packed_tiles) {
+        return 0u;
+    }
+
+    for (size_t y = 0u ; y < world->height ; y++) {
+        for (size_t x = 0u ; x < world->width ; x++) {
+            hexa_cell_pack(HEXAW_TILE(world, x, y), world->packed_tiles + (y * world->width) + x);
+        }
+    }
+
+    return 1u;
+}
+
+// -------------------------------------------------------------------------------------------------
+static u32 hexaworld_store_sparse(hexaworld_t *world) {
+    const size_t blocks_per_row = (world->width + SPARSE_BLOCK_SIDE - 1u) / SPARSE_BLOCK_SIDE;
+    const size_t blocks_per_column = (world->height + SPARSE_BLOCK_SIDE - 1u) / SPARSE_BLOCK_SIDE;
+    hexaworld_sparse_t *sparse = NULL;
+    sparse_block_t *block = NULL;
+    sparse_group_t *group = NULL;
+    size_t group_tiles_nb[SPARSE_GROUP_KINDS_NB] = { 0u };
+    size_t ranks[SPARSE_GROUP_KINDS_NB] = { 0u };
+    size_t records_size = 0u;
+    size_t block_width = 0u;
+    size_t block_height = 0u;
+    size_t bit = 0u;
+    size_t offset = 0u;
+    size_t size = 0u;
+    u8 *record = NULL;
+
+    sparse = malloc(sizeof(*sparse) + (blocks_per_row * blocks_per_column * sizeof(*(sparse->blocks))));
+    if (!sparse) {
+        return 0u;
+    }
+    sparse->blocks_per_row = blocks_per_row;
+    sparse->blocks = (sparse_block_t *) (sparse + 1u);
+
+    // first pass finding what the tiles of each group share, so the records are allocated at once
+    for (size_t block_y = 0u ; block_y < blocks_per_column ; block_y++) {
+        block_height = MIN(SPARSE_BLOCK_SIDE, world->height - (block_y * SPARSE_BLOCK_SIDE));
+        for (size_t block_x = 0u ; block_x < blocks_per_row ; block_x++) {
+            block_width = MIN(SPARSE_BLOCK_SIDE, world->width - (block_x * SPARSE_BLOCK_SIDE));
+            block = sparse->blocks + (block_y * blocks_per_row) + block_x;
+            hexaworld_sparse_classify(world, block_x, block_y, block);
+
+            group_tiles_nb[SPARSE_GROUP_OCEAN] = (size_t) __builtin_popcountll(block->ocean_mask);
+            group_tiles_nb[SPARSE_GROUP_LAND] = (block_width * block_height) - group_tiles_nb[SPARSE_GROUP_OCEAN];
+            for (size_t i = 0u ; i < SPARSE_GROUP_KINDS_NB ; i++) {
+                block->groups[i].first_record = records_size;
+                records_size += group_tiles_nb[i] * block->groups[i].record_size;
+            }
+        }
+    }
+
+    sparse->records = malloc(MAX(records_size, 1u));
+    if (!sparse->records) {
+        free(sparse);
+        return 0u;
+    }
+    sparse->footprint = sizeof(*sparse) + (blocks_per_row * blocks_per_column * sizeof(*(sparse->blocks))) + records_size;
+
+    // second pass storing the fields each tile does not share with its group
+    for (size_t block_y = 0u ; block_y < blocks_per_column ; block_y++) {
+        block_height = MIN(SPARSE_BLOCK_SIDE, world->height - (block_y * SPARSE_BLOCK_SIDE));
+        for (size_t block_x = 0u ; block_x < blocks_per_row ; block_x++) {
+            block_width = MIN(SPARSE_BLOCK_SIDE, world->width - (block_x * SPARSE_BLOCK_SIDE));
+            block = sparse->blocks + (block_y * blocks_per_row) + block_x;
+            ranks[SPARSE_GROUP_OCEAN] = 0u;
+            ranks[SPARSE_GROUP_LAND] = 0u;
+
+            for (size_t y = 0u ; y < block_height ; y++) {
+                for (size_t x = 0u ; x < block_width ; x++) {
+                    bit = (y * block_width) + x;
+                    group = block->groups + (((block->ocean_mask >> bit) & 0x01) ? SPARSE_GROUP_OCEAN : SPARSE_GROUP_LAND);
+                    record = sparse->records + group->first_record + (ranks[group - block->groups] * group->record_size);
+                    ranks[group - block->groups] += 1u;
+
+                    for (size_t i = 0u ; i < HEXAW_FIELDS_NB ; i++) {
+                        if (group->varying_fields & HEXAW_FIELD(i)) {
+                            hexa_cell_field_span((hexa_cell_field_t) i, &offset, &size);
+                            memcpy(record, (u8 *) HEXAW_TILE(world, (block_x * SPARSE_BLOCK_SIDE) + x, (block_y * SPARSE_BLOCK_SIDE) + y) + offset, size);
+                            record += size;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    world->sparse = sparse;
+
+    return 1u;
+}
+
+// -------------------------------------------------------------------------------------------------
+static void hexaworld_sparse_classify(const hexaworld_t *world, size_t block_x, size_t block_y, sparse_block_t *block) {
+    const size_t x_start = block_x * SPARSE_BLOCK_SIDE;
+    const size_t y_start = block_y * SPARSE_BLOCK_SIDE;
+    const size_t block_width = MIN(SPARSE_BLOCK_SIDE, world->width - x_start);
+    const size_t block_height = MIN(SPARSE_BLOCK_SIDE, world->height - y_start);
+    u32 is_started[SPARSE_GROUP_KINDS_NB] = { 0u };
+    sparse_group_kind_t kind = SPARSE_GROUP_OCEAN;
+    sparse_group_t *group = NULL;
+    const hexa_cell_t *tile = NULL;
+    size_t offset = 0u;
+    size_t size = 0u;
+
+    *block = (sparse_block_t) { 0u };
+
+    for (size_t y = 0u ; y < block_height ; y++) {
+        for (size_t x = 0u ; x < block_width ; x++) {
+            tile = HEXAW_TILE(world, x_start + x, y_start + y);
+            kind = hexaworld_tile_is_land(tile) ? SPARSE_GROUP_LAND : SPARSE_GROUP_OCEAN;
+            group = block->groups + kind;
+            block->ocean_mask |= ((u64) (kind == SPARSE_GROUP_OCEAN)) << ((y * block_width) + x);
+
+            // the first tile of a group is the one the others are compared to
+            if (!is_started[kind]) {
+                group->shared_tile = *tile;
+                is_started[kind] = 1u;
+                continue;
+            }
+
+            // the fields are compared bit for bit, so a negative zero or a NaN comes back as it was
+            for (size_t i = 0u ; i < HEXAW_FIELDS_NB ; i++) {
+                if (group->varying_fields & HEXAW_FIELD(i)) {
+                    continue;
+                }
+
+                hexa_cell_field_span((hexa_cell_field_t) i, &offset, &size);
+                if (memcmp((const u8 *) tile + offset, (const u8 *) &(group->shared_tile) + offset, size) != 0) {
+                    group->varying_fields |= HEXAW_FIELD(i);
+                    group->record_size += size;
+                }
+            }
+        }
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static hexa_cell_t hexaworld_sparse_tile(const hexaworld_t *world, size_t x, size_t y) {
+    const sparse_block_t *block = world->sparse->blocks + ((y / SPARSE_BLOCK_SIDE) * world->sparse->blocks_per_row) + (x / SPARSE_BLOCK_SIDE);
+    const size_t block_width = MIN(SPARSE_BLOCK_SIDE, world->width - (x - (x % SPARSE_BLOCK_SIDE)));
+    const size_t bit = ((y % SPARSE_BLOCK_SIDE) * block_width) + (x % SPARSE_BLOCK_SIDE);
+    const u32 is_ocean = (block->ocean_mask >> bit) & 0x01;
+    // number of ocean tiles before this one in the block, the other tiles before it being land ones
+    const size_t ocean_before = (size_t) __builtin_popcountll(block->ocean_mask & ((((u64) 1u) << bit) - 1u));
+    const sparse_group_t *group = block->groups + (is_ocean ? SPARSE_GROUP_OCEAN : SPARSE_GROUP_LAND);
+    const u8 *record = world->sparse->records + group->first_record + ((is_ocean ? ocean_before : (bit - ocean_before)) * group->record_size);
+    hexa_cell_t tile = group->shared_tile;
+    size_t offset = 0u;
+    size_t size = 0u;
+
+    for (size_t i = 0u ; i < HEXAW_FIELDS_NB ; i++) {
+        if (group->varying_fields & HEXAW_FIELD(i)) {
+            hexa_cell_field_span((hexa_cell_field_t) i, &offset, &size);
+            memcpy((u8 *) &tile + offset, record, size);
+            record += size;
+        }
+    }
+
+    return tile;
+}
@@ -13,6 +13,8 @@
 
 #include <unstandard.h>
 #include <hexagonparadigm.h>
+#include <cellotomaton.h>
+#include <taskpool.h>
 
 #include "worldcomponents/layers.h"
 
@@ -21,15 +23,80 @@
  */
 typedef struct hexaworld_t hexaworld_t;
 
+/**
+ * @brief Forms the tiles of a world can be kept in (see `hexaworld_settle()`).
+ */
+typedef enum hexaworld_storage_t {
+    HEXAW_STORAGE_DENSE,    ///< the tiles are held by the world's automaton, as they were generated
+    HEXAW_STORAGE_PACKED,   ///< the tiles are packed (see `hexa_cell_packed_t`), their ratios and winds in fixed point
+    HEXAW_STORAGE_SPARSE,   ///< the tiles are kept exactly in square blocks, the fields shared by the ocean (or land) tiles of a block stored once
+
+    HEXAW_STORAGES_NB,      ///< number of storage forms
+} hexaworld_storage_t;
+
+/**
+ * @brief What a world generated within a time budget gave up to be done in time.
+ */
+typedef struct hexaworld_generation_report_t {
+    /// time the generation took, in milliseconds
+    f64 elapsed;
+    /// number of coarser worlds the layers were generated on (see `hexaworld_set_coarse_levels()`)
+    u32 coarse_levels;
+    /// number of those coarser worlds added for the generation to fit in its budget
+    u32 added_coarse_levels;
+    /// number of iterations each layer would have gone through at the world's size without a deadline
+    u32 iterations_wanted[HEXAW_LAYERS_NUMBER];
+    /// number of iterations each layer went through at the world's size
+    u32 iterations_done[HEXAW_LAYERS_NUMBER];
+    /// set of `hexaworld_layer_t` bit offsets of the layers stopped by their deadline before being done
+    flag_set32_t degraded_layers;
+    /// shortest time the generation was predicted to take whatever its budget, in milliseconds, 0 if it could not be
+    /// predicted : each layer is still seeded or upsampled and flagged at each size, and iterated once on the coarsest
+    f64 predicted_floor;
+    /// 1 if the generation took longer than its budget, 0 otherwise
+    u32 budget_missed;
+} hexaworld_generation_report_t;
+
+/**
+ * @brief One field of the tiles of a world in the dense form, read in place : the field of the tile (x, y) starts at
+ * `base + (y * row_pitch) + (x * stride)`.
+ */
+typedef struct hexaworld_field_view_t {
+    /// field of the first tile, NULL if the world is not in the dense form
+    const u8 *base;
+    /// size of the field, in bytes
+    size_t element_size;
+    /// bytes from the field of a tile to the field of the next tile of its row
+    size_t stride;
+    /// bytes from the field of a tile to the field of the tile below it
+    size_t row_pitch;
+    /// number of tiles of a row
+    size_t width;
+    /// number of rows
+    size_t height;
+} hexaworld_field_view_t;
+
 /**
  * @brief Creates an empty, zero-initialized world on the heap.
  * 
  * @param[in] width number of tiles on the x-axis
  * @param[in] height number of tiles on the y-axis
  * @param[in] random_seed seed for the RNG
+ * @param[in] pool pool of threads generating the layers, shared with the caller and that must outlive the world (can be NULL)
  * @return hexaworld_t* a pointer to the world data, NULL if allocation failed
  */
-hexaworld_t *hexaworld_create_empty(size_t width, size_t height, i32 random_seed);
+hexaworld_t *hexaworld_create_empty(size_t width, size_t height, i32 random_seed, task_pool_t *pool);
+
+/**
+ * @brief Returns the memory a world of the given dimensions takes once created, with everything its layers need
+ * while generating (the frontier and the land mask included), its coarser levels left aside.
+ * 
+ * @param[in] width number of tiles on the x-axis
+ * @param[in] height number of tiles on the y-axis
+ * @param[in] pool pool of threads the world would be generated with (can be NULL)
+ * @return size_t size of the world, in bytes
+ */
+size_t hexaworld_footprint(size_t width, size_t height, task_pool_t *pool);
 
 /**
  * @brief Deallocates the world and sets the pointer to NULL.
@@ -52,8 +119,33 @@ void hexaworld_draw(hexaworld_t *world, hexaworld_layer_t layer, f32 rectangle_t
  * 
  * @param[inout] world non-NULL pointer to some world data
  * @param[in] layer (re-)generated layer
+ * @return u32 number of iterations the automaton went through, less than the layer's count if it converged earlier
  */
-void hexaworld_genlayer(hexaworld_t *world, hexaworld_layer_t layer);
+u32 hexaworld_genlayer(hexaworld_t *world, hexaworld_layer_t layer);
+
+/**
+ * @brief Generates a single layer of the world, its iterations stopping once a deadline passed. The layer always
+ * goes through at least one iteration on the coarsest world, and none on the finer ones once the deadline passed.
+ * 
+ * @param[inout] world non-NULL pointer to some world data
+ * @param[in] layer (re-)generated layer
+ * @param[in] deadline time on the clock of `otomaton_now()`, in milliseconds, 0 to generate the layer without a deadline
+ * @return u32 number of iterations the automaton went through at the world's size
+ */
+u32 hexaworld_genlayer_until(hexaworld_t *world, hexaworld_layer_t layer, f64 deadline);
+
+/**
+ * @brief Razes the world and generates all its layers within a time budget. The budget is split across the layers
+ * from the time each one took per tile the last time it was generated : if the whole world cannot fit in it, the
+ * layers are first generated on coarser worlds, and each layer's iterations stop at the end of its share of the
+ * budget. The world's own coarser worlds are given back once it is done. A budget under the predicted floor of the
+ * generation cannot be met, and the report tells when the budget was missed.
+ * 
+ * @param[inout] world non-NULL pointer to some world data
+ * @param[in] budget time the generation should take, in milliseconds, 0 to generate the world without any deadline
+ * @param[out] report what was given up to fit in the budget, can be NULL
+ */
+void hexaworld_generate(hexaworld_t *world, f64 budget, hexaworld_generation_report_t *report);
 
 /**
  * @brief Sets all the layer's data to a blank state.
@@ -70,9 +162,84 @@ void hexaworld_raze(hexaworld_t *world);
  */
 void hexaworld_reseed(hexaworld_t *world, i32 new_seed);
 
+/**
+ * @brief Changes the size of a world and razes it, reusing the memory it already holds when it is large enough. The
+ * world keeps its seed, its traversal and as many coarser worlds as its new size allows.
+ * 
+ * @param[inout] world target world
+ * @param[in] width new number of tiles on the x-axis
+ * @param[in] height new number of tiles on the y-axis
+ * @return u32 1 if the world was resized, 0 if there was not enough memory and it was left as it was
+ */
+u32 hexaworld_resize(hexaworld_t *world, size_t width, size_t height);
+
+/**
+ * @brief Changes the order in which the world's automaton visits the tiles. The generated world does not depend on it.
+ * 
+ * @param[inout] world target world
+ * @param[in] traversal new traversal order
+ */
+void hexaworld_set_traversal(hexaworld_t *world, otomaton_traversal_t traversal);
+
+/**
+ * @brief Makes the world generate its layers coarse to fine : each layer is first generated on a world of half the
+ * width and height (itself generated the same way). A layer iterated by the automaton is then upsampled to the world's
+ * size and only refined by a few iterations, the others are seeded again at the world's size. The generated world is
+ * close to, but not the same as, one generated at full size.
+ * 
+ * @param[inout] world target world
+ * @param[in] levels_nb number of coarser worlds under the world, 0 to generate the layers at full size only
+ * @return u32 number of coarser worlds actually made, less than wanted if the world would become too small or an allocation failed
+ */
+u32 hexaworld_set_coarse_levels(hexaworld_t *world, u32 levels_nb);
+
+/**
+ * @brief Keeps the tiles of a generated world in another form, for as long as it is only read. A world settled out
+ * of the dense form gives back its automaton and its coarser worlds, and its tiles are only read through
+ * `hexaworld_tile()`. Generating, razing or resizing the world brings its automaton back, filled with the tiles as
+ * they were stored and with the land mask rebuilt from them ; its coarser worlds have to be set again.
+ * Settling only shrinks a world once it is generated : generating it still takes `hexaworld_footprint()`, the two
+ * dense buffers of the automaton holding every field of every tile while the layers run.
+ * 
+ * @param[inout] world non-NULL pointer to some world data
+ * @param[in] storage form the tiles are kept in
+ * @return u32 1 if the tiles are now in this form, 0 if there was not enough memory (the tiles are unchanged, if maybe back in the dense form)
+ */
+u32 hexaworld_settle(hexaworld_t *world, hexaworld_storage_t storage);
+
+/**
+ * @brief Returns a tile of a world, whatever the form its tiles are kept in.
+ * 
+ * @param[in] world non-NULL pointer to some world data
+ * @param[in] x x coordinate of the tile
+ * @param[in] y y coordinate of the tile
+ * @return hexa_cell_t copy of the tile
+ */
+hexa_cell_t hexaworld_tile(const hexaworld_t *world, size_t x, size_t y);
+
+/**
+ * @brief Returns a view over one field of the tiles of a world in the dense form, without copying them. The view
+ * follows the tiles until the world is generated, razed, resized or settled again.
+ * 
+ * @param[in] world non-NULL pointer to some world data
+ * @param[in] field viewed field
+ * @return hexaworld_field_view_t view over the field, its base NULL if the world is settled out of the dense form
+ */
+hexaworld_field_view_t hexaworld_field_view(const hexaworld_t *world, hexa_cell_field_t field);
+
+/**
+ * @brief Returns the memory taken by the tiles of a world in the form they are kept in, the automaton holding them
+ * included. The coarser worlds are left aside.
+ * 
+ * @param[in] world non-NULL pointer to some world data
+ * @return size_t size of the tiles, in bytes
+ */
+size_t hexaworld_tiles_footprint(const hexaworld_t *world);
+
 /**
  * @brief Returns a pointer to a tile at the position (x, y) inside a reference rectangle.
- * Returns NULL if the coordinates are out of bounds.
+ * Returns NULL if the coordinates are out of bounds. The tile of a settled world is a copy, held by the world until
+ * the next call.
  * 
  * @param[in] world target world
  * @param[in] x x pixel coordinates
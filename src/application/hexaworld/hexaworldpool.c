@@ -0,0 +1,146 @@
+/**
+ * @file hexaworldpool.c
+ * @author gabriel 
+ * @brief Definition file for the pool of worlds.
+ * @version 0.1
+ * @date 2023-05-07
+ * 
+ * @copyright Copyright (c) 2023
+ * 
+ */
+#include "hexaworldpool.h"
+
+#include <stdlib.h>
+
+#include "worldcomponents/hexaworldcomponents.h"
+
+// -------------------------------------------------------------------------------------------------
+// ---- TYPE DEFINITIONS ---------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Definition of a pool of worlds.
+ */
+typedef struct hexaworld_pool_t {
+    /// pool of threads given to the created worlds, not owned by the pool
+    task_pool_t *pool;
+    /// largest number of parked worlds
+    size_t capacity;
+    /// number of parked worlds
+    size_t worlds_nb;
+    /// parked worlds, in the order they were given
+    hexaworld_t *worlds[];
+} hexaworld_pool_t;
+
+// -------------------------------------------------------------------------------------------------
+// ---- STATIC FUNCTIONS DECLARATIONS --------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Removes a world from the parked ones and returns it.
+ * 
+ * @param[inout] world_pool target pool
+ * @param[in] index index of the parked world
+ * @return hexaworld_t* world now owned by the caller
+ */
+static hexaworld_t *hexaworld_pool_unpark(hexaworld_pool_t *world_pool, size_t index);
+
+// -------------------------------------------------------------------------------------------------
+// ---- HEADER FUNCTIONS DEFINITIONS ---------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+// -------------------------------------------------------------------------------------------------
+hexaworld_pool_t *hexaworld_pool_create(size_t capacity, task_pool_t *pool) {
+    hexaworld_pool_t *world_pool = NULL;
+
+    world_pool = malloc(sizeof(*world_pool) + (capacity * sizeof(*(world_pool->worlds))));
+    if (!world_pool) {
+        return NULL;
+    }
+
+    world_pool->pool = pool;
+    world_pool->capacity = capacity;
+    world_pool->worlds_nb = 0u;
+
+    return world_pool;
+}
+
+// -------------------------------------------------------------------------------------------------
+void hexaworld_pool_destroy(hexaworld_pool_t **world_pool) {
+    if (*world_pool) {
+        for (size_t i = 0u ; i < (*world_pool)->worlds_nb ; i++) {
+            hexaworld_destroy((*world_pool)->worlds + i);
+        }
+
+        free(*world_pool);
+    }
+
+    *world_pool = NULL;
+}
+
+// -------------------------------------------------------------------------------------------------
+hexaworld_t *hexaworld_pool_take(hexaworld_pool_t *world_pool, size_t width, size_t height, i32 random_seed) {
+    hexaworld_t *world = NULL;
+    size_t largest = 0u;
+
+    if (world_pool->worlds_nb == 0u) {
+        return hexaworld_create_empty(width, height, random_seed, world_pool->pool);
+    }
+
+    // a world of the same size only needs to be razed, otherwise the largest world is the most likely to be resized
+    // without allocating anything
+    for (size_t i = 0u ; i < world_pool->worlds_nb ; i++) {
+        if ((world_pool->worlds[i]->width == width) && (world_pool->worlds[i]->height == height)) {
+            largest = i;
+            break;
+        }
+        if ((world_pool->worlds[i]->width * world_pool->worlds[i]->height) > (world_pool->worlds[largest]->width * world_pool->worlds[largest]->height)) {
+            largest = i;
+        }
+    }
+
+    world = hexaworld_pool_unpark(world_pool, largest);
+
+    // contengency : resizing needs the old and the new memory at once, a new world only the new one
+    if (!hexaworld_resize(world, width, height)) {
+        hexaworld_destroy(&world);
+        return hexaworld_create_empty(width, height, random_seed, world_pool->pool);
+    }
+    hexaworld_reseed(world, random_seed);
+
+    return world;
+}
+
+// -------------------------------------------------------------------------------------------------
+void hexaworld_pool_give(hexaworld_pool_t *world_pool, hexaworld_t **world) {
+    if (!(*world)) {
+        return;
+    }
+
+    if (world_pool->worlds_nb == world_pool->capacity) {
+        hexaworld_destroy(world);
+        return;
+    }
+
+    world_pool->worlds[world_pool->worlds_nb] = *world;
+    world_pool->worlds_nb += 1u;
+
+    *world = NULL;
+}
+
+// -------------------------------------------------------------------------------------------------
+// ---- STATIC FUNCTIONS DEFINITIONS ---------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+// -------------------------------------------------------------------------------------------------
+static hexaworld_t *hexaworld_pool_unpark(hexaworld_pool_t *world_pool, size_t index) {
+    hexaworld_t *world = world_pool->worlds[index];
+
+    // keeping the order in which the worlds were given
+    for (size_t i = index + 1u ; i < world_pool->worlds_nb ; i++) {
+        world_pool->worlds[i - 1u] = world_pool->worlds[i];
+    }
+    world_pool->worlds_nb -= 1u;
+
+    return world;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file hexaworldpool.h
+ * @author gabriel 
+ * @brief Keeps generated-out worlds aside so the next ones reuse their memory instead of allocating their own.
+ * A world given back to the pool is parked as it is ; a world taken from the pool is one of the parked worlds of
+ * the same size if there is one, any parked world resized otherwise, and a new world only if none is parked.
+ * @version 0.1
+ * @date 2023-05-07
+ * 
+ * @copyright Copyright (c) 2023
+ * 
+ */
+#ifndef __HEXAWORLDPOOL_H__
+#define __HEXAWORLDPOOL_H__
+
+#include <unstandard.h>
+#include <taskpool.h>
+
+#include "hexaworld.h"
+
+/**
+ * @brief Parked worlds, as an opaque type.
+ */
+typedef struct hexaworld_pool_t hexaworld_pool_t;
+
+/**
+ * @brief Creates an empty pool of worlds on the heap.
+ * 
+ * @param[in] capacity largest number of worlds parked at the same time
+ * @param[in] pool pool of threads given to the worlds created by the pool, that must outlive them (can be NULL)
+ * @return hexaworld_pool_t* a pointer to the pool, NULL if allocation failed
+ */
+hexaworld_pool_t *hexaworld_pool_create(size_t capacity, task_pool_t *pool);
+
+/**
+ * @brief Destroys a pool and the worlds still parked in it. The function will set the pointed pointer to NULL.
+ * 
+ * @param[inout] world_pool pool to release
+ */
+void hexaworld_pool_destroy(hexaworld_pool_t **world_pool);
+
+/**
+ * @brief Returns a blank world of some size, reusing a parked world if there is one.
+ * 
+ * @param[inout] world_pool target pool
+ * @param[in] width number of tiles on the x-axis
+ * @param[in] height number of tiles on the y-axis
+ * @param[in] random_seed seed for the RNG
+ * @return hexaworld_t* a razed world owned by the caller, NULL if allocation failed
+ */
+hexaworld_t *hexaworld_pool_take(hexaworld_pool_t *world_pool, size_t width, size_t height, i32 random_seed);
+
+/**
+ * @brief Parks a world in a pool, or destroys it if the pool is full. The function will set the pointed pointer to NULL.
+ * 
+ * @param[inout] world_pool target pool
+ * @param[inout] world world given to the pool, created with the same pool of threads
+ */
+void hexaworld_pool_give(hexaworld_pool_t *world_pool, hexaworld_t **world);
+
+#endif
@@ -16,6 +16,7 @@
 #include <hexagonparadigm.h>
 
 #include "layers.h"
+#include "../hexaworld.h"
 
 // -------------------------------------------------------------------------------------------------
 // ---- CONSTANTS ----------------------------------------------------------------------------------
@@ -63,6 +64,11 @@
 #define WHOLE_WORLD_OCEAN_ABYSS_CUTOUT (0.50f)  ///< height ratio for abyss ocean -> normal ocean drawing 
 #define WHOLE_WORLD_OCEAN_REEF_CUTOUT  (0.25f)  ///< height ratio for normal ocean -> reef ocean drawing
 
+#define COARSE_TO_FINE_MIN_SIDE (16u)       ///< a world is never halved into a coarser one with a side shorter than this
+#define COARSE_TO_FINE_REFINEMENT_ITER (4u) ///< most automaton iterations a layer goes through once upsampled from a coarser world
+
+#define SPARSE_BLOCK_SIDE (8u)              ///< side, in number of tiles, of the square blocks a sparse world is stored in, a bit of a block's mask for each tile
+
 // -------------------------------------------------------------------------------------------------
 // ---- TYPEDEFS -----------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -97,33 +103,110 @@ typedef struct layer_calls_t {
     layer_seed_function_t seed_func;
     /// function applied by the automaton to generate a single cell
     apply_to_cell_func_t automaton_func;
+    /// function applied by the automaton to generate a whole row of cells, used instead of `automaton_func` if not NULL (see `OTOMATON_ROW_KERNEL()`)
+    apply_to_row_func_t automaton_row_func;
     /// function applied by the automaton to create the flags of a single cell
     apply_to_cell_func_t flag_gen_func;
-    /// number of times the automaton applies the `automaton_func` toeach cell of the world
+    /// options given to the automaton along with `automaton_func`
+    flag_set8_t automaton_options;
+    /// options given to the automaton along with `flag_gen_func`
+    flag_set8_t flag_gen_options;
+    /// with the convergence option, fraction of the world that can still change once the layer is considered done
+    f32 automaton_tolerance;
+    /// number of times the automaton applies the `automaton_func` toeach cell of the world, at most if the layer converges
     u32 automaton_iter;
     /// way the automaton should iterate over the array
     layer_gen_iteration_type_t iteration_flavour;
+    /// set of `hexa_cell_field_t` bit offsets written by the layer's seed, automaton and flag functions (whole cells if 0)
+    flag_set32_t fields_written;
 } layer_calls_t;
 
+// -------------------------------------------------------------------------------------------------
+typedef enum sparse_group_kind_t {
+    SPARSE_GROUP_OCEAN,     ///< tiles of a block at or under the sea level
+    SPARSE_GROUP_LAND,      ///< tiles of a block above the sea level
+
+    SPARSE_GROUP_KINDS_NB,
+} sparse_group_kind_t;
+
+// -------------------------------------------------------------------------------------------------
+typedef struct sparse_group_t {
+    /// fields shared by all the tiles of the group, the others being the ones of its first tile
+    hexa_cell_t shared_tile;
+    /// set of `hexa_cell_field_t` bit offsets of the fields differing between the tiles of the group, the only ones stored for each tile
+    flag_set32_t varying_fields;
+    /// number of bytes stored for each tile of the group, its varying fields one after the other
+    size_t record_size;
+    /// offset of the first tile of the group in the records, the others following in the block's order
+    size_t first_record;
+} sparse_group_t;
+
+// -------------------------------------------------------------------------------------------------
+typedef struct sparse_block_t {
+    /// one bit for each tile of the block, row after row, set if the tile is in the ocean group
+    u64 ocean_mask;
+    /// ocean and land tiles of the block
+    sparse_group_t groups[SPARSE_GROUP_KINDS_NB];
+} sparse_block_t;
+
+// -------------------------------------------------------------------------------------------------
+typedef struct hexaworld_sparse_t {
+    /// number of blocks on the x-axis
+    size_t blocks_per_row;
+    /// blocks, row after row
+    sparse_block_t *blocks;
+    /// varying fields of the tiles, block after block and group after group
+    u8 *records;
+    /// size of the blocks and the records, in bytes
+    size_t footprint;
+} hexaworld_sparse_t;
+
 // -------------------------------------------------------------------------------------------------
 typedef struct hexaworld_t { 
     /// layers generation functions
     layer_calls_t hexaworld_layers_functions[HEXAW_LAYERS_NUMBER];
 
-    /// 2d heap-allocated array of the tiles
-    hexa_cell_t **tiles;
+    /// form the tiles are kept in, the automaton only holding them in the dense form
+    hexaworld_storage_t storage;
+    /// tiles stored row after row, owned by the automaton and moved by each of its applications, NULL once settled
+    hexa_cell_t *tiles;
+    /// tiles of a world settled in the packed form, row after row, NULL otherwise
+    hexa_cell_packed_t *packed_tiles;
+    /// tiles of a world settled in the sparse form, NULL otherwise
+    hexaworld_sparse_t *sparse;
+    /// copy of the last tile of a settled world handed out by `hexaworld_tile_at()`
+    hexa_cell_t examined_tile;
     /// number of tiles on the x-axis
     size_t width;
     /// number of tiles on the y-axis
     size_t height;
+    /// number of tiles between the starts of two consecutive rows, larger than the width
+    size_t row_pitch;
 
-    /// pointer to an heap-allocated cellular automaton for layer generation
+    /// pointer to an heap-allocated cellular automaton for layer generation, NULL once settled
     cell_automaton_t *automaton;
+    /// order in which the automaton visits the tiles, kept for the automaton made again after the world was settled
+    otomaton_traversal_t traversal;
 
     /// seed used for the map generation
     i32 map_seed;
+
+    /// pool of threads given at creation, shared with the coarser worlds
+    task_pool_t *pool;
+    /// world of about half the width and height generated before this one and upsampled into it, NULL if the layers are generated at full size only
+    struct hexaworld_t *coarser;
+
+    /// milliseconds an iteration of each layer took per tile the last time it went through any at this size, 0 if it never did
+    f64 layer_costs[HEXAW_LAYERS_NUMBER];
+    /// milliseconds the passes of each layer around its iterations (seeding or upsampling, flags and mask) took per tile the last time it was generated at this size, 0 if it never was
+    f64 layer_pass_costs[HEXAW_LAYERS_NUMBER];
+    /// iterations each layer went through the last time it was generated at this size without a coarser world, 0 if it never was
+    u32 layer_iterations[HEXAW_LAYERS_NUMBER];
 } hexaworld_t;
 
+/// pointer to the tile at the coordinates (x, y) of a world in the dense form
+#define HEXAW_TILE(_world, _x, _y) ((_world)->tiles + ((_y) * (_world)->row_pitch) + (_x))
+
 // -------------------------------------------------------------------------------------------------
 // ---- LAYERS CALLS DATA --------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -36,7 +36,7 @@ static void altitude_seed(hexaworld_t *world) {
 
     for (size_t x = 0u ; x < world->width ; x++) {
         for (size_t y = 0u ; y < world->height ; y++) {
-            tmp_cell = world->tiles[x] + y;
+            tmp_cell = HEXAW_TILE(world, x, y);
 
             if (hexa_cell_has_flag(tmp_cell, HEXAW_FLAG_MOUNTAIN)) {
                 tmp_cell->altitude = (alt_m_t) ((ALTITUDE_MAX / 4) + (rand() % (3*ALTITUDE_MAX / 4)));
@@ -53,33 +53,39 @@ static void altitude_seed(hexaworld_t *world) {
 }
 
 // -------------------------------------------------------------------------------------------------
-static void altitude_apply(void *target_cell, void *neighbors[DIRECTIONS_NB]) {
-    hexa_cell_t *cell = (hexa_cell_t *) target_cell;
+static void altitude_apply_row(void *target_row, void *rows[ROW_NEIGHBORHOOD_NB], size_t width, u32 parity) {
+    hexa_cell_t *cells = (hexa_cell_t *) target_row;
+    const hexa_cell_t *above = (hexa_cell_t *) rows[ROW_ABOVE];
+    const hexa_cell_t *current = (hexa_cell_t *) rows[ROW_CURRENT];
+    const hexa_cell_t *below = (hexa_cell_t *) rows[ROW_BELOW];
 
-    hexa_cell_t *tmp_cell = NULL;
-    i32 mean_altitude = 0;
+    // even rows are shifted to the west of odd rows, so their diagonal neighbors start a cell earlier
+    const i64 shift = (i64) parity - 1;
 
-    for (size_t i = 0u ; i < DIRECTIONS_NB ; i++) {
-        tmp_cell = (hexa_cell_t *) neighbors[i];
+    i32 mean_altitude = 0;
 
-        mean_altitude += (i32) tmp_cell->altitude;
-    }
-    mean_altitude += (i32) cell->altitude * ALTITUDE_EROSION_INERTIA_WEIGHT;
+    for (i64 x = 0 ; x < (i64) width ; x++) {
+        mean_altitude = (i32) current[x - 1].altitude + (i32) current[x + 1].altitude
+                + (i32) above[x + shift].altitude + (i32) above[x + shift + 1].altitude
+                + (i32) below[x + shift].altitude + (i32) below[x + shift + 1].altitude;
+        mean_altitude += (i32) cells[x].altitude * ALTITUDE_EROSION_INERTIA_WEIGHT;
 
-    mean_altitude /= (DIRECTIONS_NB + ALTITUDE_EROSION_INERTIA_WEIGHT);
+        mean_altitude /= (DIRECTIONS_NB + ALTITUDE_EROSION_INERTIA_WEIGHT);
 
-    if (SGN_I32((cell->altitude - 1)) != SGN_I32(mean_altitude)) {
-        return;
+        if (SGN_I32((cells[x].altitude - 1)) == SGN_I32(mean_altitude)) {
+            cells[x].altitude = (alt_m_t) mean_altitude;
+        }
     }
-
-    cell->altitude = (alt_m_t) mean_altitude;
 }
 
 const layer_calls_t altitude_layer_calls = {
         .draw_func          = &altitude_draw,
         .seed_func          = &altitude_seed,
-        .automaton_func     = &altitude_apply,
+        .automaton_func     = NULL,
+        .automaton_row_func = &altitude_apply_row,
         .flag_gen_func      = NULL, 
+        .automaton_options  = OTOMATON_OPTION(OTOMATON_OPTION_TIME_BLOCKS),
         .automaton_iter     = ITERATION_NB_ALTITUDE,
-        .iteration_flavour  = LAYER_GEN_ITERATE_ABSOLUTE
+        .iteration_flavour  = LAYER_GEN_ITERATE_ABSOLUTE,
+        .fields_written     = HEXAW_FIELD(HEXAW_FIELD_ALTITUDE)
 };
@@ -32,7 +32,7 @@ static void cloud_cover_draw(hexa_cell_t *cell, hexagon_shape_t *target_shape) {
 static void cloud_cover_seed(hexaworld_t *world) {
     for (size_t x = 0u ; x < world->width ; x++) {
         for (size_t y = 0u ; y < world->height ; y++) {
-            world->tiles[x][y].cloud_cover = (f32) (world->tiles[x][y].altitude <= 0);
+            HEXAW_TILE(world, x, y)->cloud_cover = (f32) (HEXAW_TILE(world, x, y)->altitude <= 0);
         }
     }
 }
@@ -88,11 +88,17 @@ static void cloud_cover_apply(void *target_cell, void *neighbors[DIRECTIONS_NB])
     cell->cloud_cover -= cell->precipitations;
 }
 
+// -------------------------------------------------------------------------------------------------
+OTOMATON_ROW_KERNEL(cloud_cover_apply_row, hexa_cell_t, cloud_cover_apply)
+
 const layer_calls_t cloud_cover_layer_calls = {
         .draw_func          = &cloud_cover_draw,
         .seed_func          = &cloud_cover_seed,
         .automaton_func     = &cloud_cover_apply,
+        .automaton_row_func = &cloud_cover_apply_row,
         .flag_gen_func      = NULL, 
+        .automaton_options  = OTOMATON_OPTION(OTOMATON_OPTION_TIME_BLOCKS) | OTOMATON_OPTION(OTOMATON_OPTION_MASKED),
         .automaton_iter     = ITERATION_NB_CLOUD_COVER,
-        .iteration_flavour  = LAYER_GEN_ITERATE_ABSOLUTE    
+        .iteration_flavour  = LAYER_GEN_ITERATE_ABSOLUTE,
+        .fields_written     = HEXAW_FIELD(HEXAW_FIELD_CLOUD_COVER) | HEXAW_FIELD(HEXAW_FIELD_PRECIPITATIONS)
 };
\ No newline at end of file
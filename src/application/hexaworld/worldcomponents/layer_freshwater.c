@@ -75,17 +75,17 @@ static void freshwater_seed(hexaworld_t *world){
     for (size_t x = 0u ; x < world->width ; x++) {
         for (size_t y = 0u ; y < world->height ; y++) {
 
-            if ((world->tiles[x][y].altitude <= 0) || (world->tiles[x][y].temperature <= -5)) {
+            if ((HEXAW_TILE(world, x, y)->altitude <= 0) || (HEXAW_TILE(world, x, y)->temperature <= -5)) {
                 continue;
             }
 
-            if (world->tiles[x][y].precipitations > FRESHWATER_PRECIPITATIONS_THRESHOLD) {
-                world->tiles[x][y].freshwater_height = FRESHWATER_SOURCE_START_DEPTH;
-            } else if (hexa_cell_has_flag(world->tiles[x] + y, HEXAW_FLAG_MOUNTAIN)) {
-                world->tiles[x][y].freshwater_height = ((rand() % FRESHWATER_MOUNTAIN_NO_SOURCE_CHANCE) == 0) * FRESHWATER_SOURCE_START_DEPTH;
+            if (HEXAW_TILE(world, x, y)->precipitations > FRESHWATER_PRECIPITATIONS_THRESHOLD) {
+                HEXAW_TILE(world, x, y)->freshwater_height = FRESHWATER_SOURCE_START_DEPTH;
+            } else if (hexa_cell_has_flag(HEXAW_TILE(world, x, y), HEXAW_FLAG_MOUNTAIN)) {
+                HEXAW_TILE(world, x, y)->freshwater_height = ((rand() % FRESHWATER_MOUNTAIN_NO_SOURCE_CHANCE) == 0) * FRESHWATER_SOURCE_START_DEPTH;
             }
 
-            world->tiles[x][y].freshwater_direction = rand() % DIRECTIONS_NB;
+            HEXAW_TILE(world, x, y)->freshwater_direction = rand() % DIRECTIONS_NB;
         }
     }
 }
@@ -207,6 +207,10 @@ const layer_calls_t freshwater_layer_calls = {
         .seed_func          = &freshwater_seed,
         .automaton_func     = &freshwater_apply,
         .flag_gen_func      = &freshwater_flag_gen, 
+        .automaton_options  = OTOMATON_OPTION(OTOMATON_OPTION_FRONTIER) | OTOMATON_OPTION(OTOMATON_OPTION_CONVERGE) | OTOMATON_OPTION(OTOMATON_OPTION_MASKED),
+        .automaton_tolerance = 0.0f,
         .automaton_iter     = ITERATION_NB_FRESHWATER,
-        .iteration_flavour  = LAYER_GEN_ITERATE_ABSOLUTE
+        .iteration_flavour  = LAYER_GEN_ITERATE_ABSOLUTE,
+        .fields_written     = HEXAW_FIELD(HEXAW_FIELD_FRESHWATER_DIRECTION) | HEXAW_FIELD(HEXAW_FIELD_FRESHWATER_HEIGHT) | HEXAW_FIELD(HEXAW_FIELD_FRESHWATER_SOURCES_DIRECTIONS)
+                | HEXAW_FIELD(HEXAW_FIELD_FLAGS)
 };
\ No newline at end of file
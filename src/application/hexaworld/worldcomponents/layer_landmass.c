@@ -37,10 +37,10 @@ static void landmass_draw(hexa_cell_t *cell, hexagon_shape_t *target_shape) {
 static void landmass_seed(hexaworld_t *world) {
     for (size_t x = 0u ; x < world->width ; x++) {
         for (size_t y = 0u ; y < world->height ; y++) {
-            if (hexa_cell_has_flag(world->tiles[x] + y, HEXAW_FLAG_TELLURIC_RIDGE)) {
-                world->tiles[x][y].altitude = 1;
-            } else if (!hexa_cell_has_flag(world->tiles[x] + y, HEXAW_FLAG_TELLURIC_RIFT)){
-                world->tiles[x][y].altitude = (rand() & LANDMASS_SEEDING_CHANCE) != 0;
+            if (hexa_cell_has_flag(HEXAW_TILE(world, x, y), HEXAW_FLAG_TELLURIC_RIDGE)) {
+                HEXAW_TILE(world, x, y)->altitude = 1;
+            } else if (!hexa_cell_has_flag(HEXAW_TILE(world, x, y), HEXAW_FLAG_TELLURIC_RIFT)){
+                HEXAW_TILE(world, x, y)->altitude = (rand() & LANDMASS_SEEDING_CHANCE) != 0;
             }
         }
     }
@@ -94,11 +94,17 @@ static void landmass_flag_gen(void *target_cell, void *neighbors[DIRECTIONS_NB])
     }
 }
 
+// -------------------------------------------------------------------------------------------------
+OTOMATON_ROW_KERNEL(landmass_apply_row, hexa_cell_t, landmass_apply)
+
 const layer_calls_t landmass_layer_calls = {
         .draw_func          = &landmass_draw,
         .seed_func          = &landmass_seed,
         .automaton_func     = &landmass_apply,
+        .automaton_row_func = &landmass_apply_row,
         .flag_gen_func      = &landmass_flag_gen, 
+        .flag_gen_options   = OTOMATON_OPTION(OTOMATON_OPTION_SEQUENTIAL),
         .automaton_iter     = ITERATION_NB_LANDMASS,
-        .iteration_flavour  = LAYER_GEN_ITERATE_ABSOLUTE
+        .iteration_flavour  = LAYER_GEN_ITERATE_ABSOLUTE,
+        .fields_written     = HEXAW_FIELD(HEXAW_FIELD_ALTITUDE) | HEXAW_FIELD(HEXAW_FIELD_FLAGS)
 };
\ No newline at end of file
@@ -51,7 +51,7 @@ static void telluric_seed(hexaworld_t *world) {
     // initialising the array
     for (size_t x = 0u ; x < world->width ; x++) {
         for (size_t y = 0u ; y < world->height ; y++) {
-            world->tiles[x][y].telluric_vector = (vector_2d_polar_t) { 
+            HEXAW_TILE(world, x, y)->telluric_vector = (vector_2d_polar_t) { 
                     .angle = 0.0f,
                     .magnitude = 0.0f
             };
@@ -63,7 +63,7 @@ static void telluric_seed(hexaworld_t *world) {
         x_random = rand() % world->width;
         y_random = rand() % world->height;
 
-        world->tiles[x_random][y_random].telluric_vector = (vector_2d_polar_t) {
+        HEXAW_TILE(world, x_random, y_random)->telluric_vector = (vector_2d_polar_t) {
                 .angle = (rand() % TELLURIC_VECTOR_DIRECTIONS_NB) * TELLURIC_VECTOR_UNIT_ANGLE,
                 .magnitude = 1.0f
         };
@@ -144,6 +144,9 @@ const layer_calls_t telluric_layer_calls = {
         .seed_func          = &telluric_seed,
         .automaton_func     = &telluric_apply,
         .flag_gen_func      = &telluric_flag_gen, 
+        .automaton_options  = OTOMATON_OPTION(OTOMATON_OPTION_FRONTIER) | OTOMATON_OPTION(OTOMATON_OPTION_CONVERGE),
+        .automaton_tolerance = 0.0f,
         .automaton_iter     = ITERATION_NB_TELLURIC,
-        .iteration_flavour  = LAYER_GEN_ITERATE_RELATIVE
+        .iteration_flavour  = LAYER_GEN_ITERATE_RELATIVE,
+        .fields_written     = HEXAW_FIELD(HEXAW_FIELD_TELLURIC_VECTOR) | HEXAW_FIELD(HEXAW_FIELD_FLAGS)
 };
\ No newline at end of file
@@ -46,14 +46,14 @@ static void temperature_seed(hexaworld_t *world) {
 
     for (size_t x = 0u ; x < world->width ; x++) {
         for (size_t y = 0u ; y < world->height ; y++) {
-            world->tiles[x][y].temperature =
+            HEXAW_TILE(world, x, y)->temperature =
                     ((normal_distribution(y, equator, temp_variance)
                     / normal_distribution(equator, equator, temp_variance))
                     * TEMPERATURE_RANGE)
                     + TEMPERATURE_MIN;
             
-            if ( world->tiles[x][y].altitude >= 0) {
-                world->tiles[x][y].temperature += TEMPERATURE_ALTITUDE_MULTIPLIER * (world->tiles[x][y].altitude);
+            if ( HEXAW_TILE(world, x, y)->altitude >= 0) {
+                HEXAW_TILE(world, x, y)->temperature += TEMPERATURE_ALTITUDE_MULTIPLIER * (HEXAW_TILE(world, x, y)->altitude);
             }
         }
     }
@@ -65,5 +65,6 @@ const layer_calls_t temperature_layer_calls = {
         .automaton_func = NULL,
         .flag_gen_func = NULL,
         .automaton_iter = ITERATION_NB_TEMPERATURE,
-        .iteration_flavour = LAYER_GEN_ITERATE_ABSOLUTE
+        .iteration_flavour = LAYER_GEN_ITERATE_ABSOLUTE,
+        .fields_written = HEXAW_FIELD(HEXAW_FIELD_TEMPERATURE)
 };
\ No newline at end of file
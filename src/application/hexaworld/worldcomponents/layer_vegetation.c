@@ -77,7 +77,7 @@ static void vegetation_seed(hexaworld_t *world) {
     hexa_cell_t *tmp_tile = NULL;
     for (size_t x = 0u ; x < world->width ; x++) {
         for (size_t y = 0u ; y < world->height ; y++) {
-            tmp_tile = world->tiles[x] + y;
+            tmp_tile = HEXAW_TILE(world, x, y);
 
             if (tmp_tile->altitude <= 0) {
                 continue;
@@ -173,11 +173,17 @@ static f32 get_cloudiness_rating(hexa_cell_t *cell) {
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 
+// -------------------------------------------------------------------------------------------------
+OTOMATON_ROW_KERNEL(vegetation_apply_row, hexa_cell_t, vegetation_apply)
+
 const layer_calls_t vegetation_layer_calls = {
         .draw_func          = &vegetation_draw,
         .seed_func          = &vegetation_seed,
         .automaton_func     = &vegetation_apply,
+        .automaton_row_func = &vegetation_apply_row,
         .flag_gen_func      = &vegetation_flag_gen, 
+        .automaton_options  = OTOMATON_OPTION(OTOMATON_OPTION_MASKED),
         .automaton_iter     = ITERATION_NB_VEGETATION,
-        .iteration_flavour  = LAYER_GEN_ITERATE_ABSOLUTE
+        .iteration_flavour  = LAYER_GEN_ITERATE_ABSOLUTE,
+        .fields_written     = HEXAW_FIELD(HEXAW_FIELD_VEGETATION_COVER) | HEXAW_FIELD(HEXAW_FIELD_VEGETATION_TREES) | HEXAW_FIELD(HEXAW_FIELD_FLAGS)
 };
\ No newline at end of file
@@ -52,8 +52,8 @@ static void winds_seed(hexaworld_t *world) {
     
     for (size_t x = 0u ; x < world->width ; x++) {
         for (size_t y = 0u ; y < world->height ; y++) {
-            world->tiles[x][y].winds_vector = (vector_2d_polar_t) {
-                    .angle = fmodf(starting_angle + (PI * ((f32) (world->tiles[x][y].temperature - TEMPERATURE_MIN) / (f32) TEMPERATURE_RANGE)), PI_T_2),
+            HEXAW_TILE(world, x, y)->winds_vector = (vector_2d_polar_t) {
+                    .angle = fmodf(starting_angle + (PI * ((f32) (HEXAW_TILE(world, x, y)->temperature - TEMPERATURE_MIN) / (f32) TEMPERATURE_RANGE)), PI_T_2),
                     .magnitude = 1.0f
             };
         }
@@ -110,11 +110,17 @@ static void winds_apply(void *target_cell, void *neighbors[DIRECTIONS_NB]) {
     cell->winds_vector.magnitude *= (1.0f - (normalized_altitude_diff) * (normalized_altitude_diff > 0.10f));
 }
 
+// -------------------------------------------------------------------------------------------------
+OTOMATON_ROW_KERNEL(winds_apply_row, hexa_cell_t, winds_apply)
+
 const layer_calls_t winds_layer_calls = {
         .draw_func          = &winds_draw,
         .seed_func          = &winds_seed,
         .automaton_func     = &winds_apply,
+        .automaton_row_func = &winds_apply_row,
         .flag_gen_func      = NULL, 
+        .automaton_options  = OTOMATON_OPTION(OTOMATON_OPTION_TIME_BLOCKS),
         .automaton_iter     = ITERATION_NB_WINDS,
-        .iteration_flavour  = LAYER_GEN_ITERATE_ABSOLUTE
+        .iteration_flavour  = LAYER_GEN_ITERATE_ABSOLUTE,
+        .fields_written     = HEXAW_FIELD(HEXAW_FIELD_WINDS_VECTOR)
 };
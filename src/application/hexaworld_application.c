@@ -10,6 +10,7 @@
  */
 #include <hexaworld_application.h>
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 
@@ -18,8 +19,10 @@
 #include <colorpalette.h>
 #include <endoftheline.h>
 #include <hexagonparadigm.h>
+#include <taskpool.h>
 
 #include "hexaworld/hexaworld.h"
+#include "hexaworld/hexaworldpool.h"
 #include "infopanel/infopanel.h"
 #include "windowdivision/windowregion.h"
 
@@ -28,6 +31,8 @@
 // -------------------------------------------------------------------------------------------------
 
 #define HEXAPP_WINDOW_TITLE "hexaworld" ///< Title of the raylib window.
+#define HEXAPP_FAILURE_MESSAGE_SIZE (128u) ///< Size of the message printed when the world cannot be allocated.
+#define HEXAPP_PARKED_WORLDS_NB (1u) ///< Number of worlds kept aside between two regenerations.
 
 /**
  * @brief Lists the registered window region in the application
@@ -50,6 +55,11 @@ typedef struct hexaworld_application_data_t {
     hexaworld_t *hexaworld;
     hexaworld_layer_t current_layer;
     info_panel_t *linked_panel;
+    f64 generation_budget;
+    u32 world_width;
+    u32 world_height;
+    u32 coarse_levels;
+    hexaworld_storage_t storage;
 } hexaworld_application_data_t;
 
 /**
@@ -58,6 +68,10 @@ typedef struct hexaworld_application_data_t {
 typedef struct hexaworld_raylib_app_handle_t {
     /// application-specific world data
     hexaworld_application_data_t hexaworld_data;
+    /// threads generating the world
+    task_pool_t *pool;
+    /// worlds set aside by the regenerations, reused by the next ones
+    hexaworld_pool_t *world_pool;
 
     /// pixel width of the window
     i32 window_width;
@@ -89,11 +103,13 @@ static const f32 window_position_map[WINREGIONS_NUMBER][4u] = {
 
 static void application_end_of_the_line_destroy(void *raw_ptr_app);
 /**
- * @brief (Re-)generates all the layers of a world.
+ * @brief (Re-)generates all the layers of a world and keeps its tiles in the given form, and tells on the standard output what was given up to fit in the budget.
  * 
  * @param world target world.
+ * @param budget time the generation should take, in milliseconds, 0 for no limit
+ * @param storage form the tiles are kept in once generated, the dense one leaving the world ready to be generated again
  */
-static void generate_world(hexaworld_t *world);
+static void generate_world(hexaworld_t *world, f64 budget, hexaworld_storage_t storage);
 
 static void winregion_hexaworld_on_refresh(vector_2d_cartesian_t target_dim, void *world_data);
 
@@ -107,10 +123,11 @@ static void winregion_infopanel_on_refresh(vector_2d_cartesian_t target_dim, voi
 // -------------------------------------------------------------------------------------------------
 
 // -------------------------------------------------------------------------------------------------
-hexaworld_raylib_app_handle_t * hexaworld_raylib_app_init(i32 random_seed, u32 window_width, u32 window_height, u32 world_width, u32 world_height) {
+hexaworld_raylib_app_handle_t * hexaworld_raylib_app_init(i32 random_seed, u32 window_width, u32 window_height, u32 world_width, u32 world_height, u32 thread_nb, u32 coarse_levels, f64 generation_budget, u32 storage) {
     hexaworld_raylib_app_handle_t *handle = &module_data.real_app;
 
     i32 real_seed = 0;
+    char failure_message[HEXAPP_FAILURE_MESSAGE_SIZE] = { 0u };
 
     // computing seed
     real_seed = random_seed;
@@ -135,14 +152,33 @@ hexaworld_raylib_app_handle_t * hexaworld_raylib_app_init(i32 random_seed, u32 w
         handle->window_regions[i] = NULL;
     }
 
+    // threads shared by everything generated from now on
+    handle->pool = taskpool_create(thread_nb);
+    handle->world_pool = hexaworld_pool_create(HEXAPP_PARKED_WORLDS_NB, handle->pool);
+    if ((!handle->pool) || (!handle->world_pool)) {
+        end_of_the_line(END_OF_THE_LINE_EXIT_NO_MEMORY, "failure during application initialisation");
+    }
+
     // hexaworld allocation & initialisation of the companion data
     handle->hexaworld_data = (hexaworld_application_data_t) {
-            .hexaworld = hexaworld_create_empty(world_width, world_height, real_seed),
+            .hexaworld = hexaworld_pool_take(handle->world_pool, world_width, world_height, real_seed),
             .current_layer = HEXAW_LAYER_WHOLE_WORLD,
             .linked_panel = info_panel_create(),
+            .generation_budget = generation_budget,
+            .world_width = world_width,
+            .world_height = world_height,
+            .coarse_levels = coarse_levels,
+            .storage = (storage < HEXAW_STORAGES_NB) ? (hexaworld_storage_t) storage : HEXAW_STORAGE_DENSE,
     };
 
-    if ((!handle->hexaworld_data.hexaworld) || (!handle->hexaworld_data.linked_panel)) {
+    // contengency : the world is allocated at once, so a too large one is known before anything is generated
+    if (!handle->hexaworld_data.hexaworld) {
+        snprintf(failure_message, sizeof(failure_message), "could not allocate a %ux%u world (%.1f MiB)",
+                world_width, world_height, (f64) hexaworld_footprint(world_width, world_height, handle->pool) / (1024.0 * 1024.0));
+        end_of_the_line(END_OF_THE_LINE_EXIT_NO_MEMORY, failure_message);
+    }
+
+    if (!handle->hexaworld_data.linked_panel) {
         end_of_the_line(END_OF_THE_LINE_EXIT_NO_MEMORY, "failure during application initialisation");
     }
 
@@ -169,11 +205,12 @@ hexaworld_raylib_app_handle_t * hexaworld_raylib_app_init(i32 random_seed, u32 w
         }
     }
 
+    hexaworld_set_coarse_levels(handle->hexaworld_data.hexaworld, coarse_levels);
     info_panel_set_map_seed(handle->hexaworld_data.linked_panel, real_seed);
 
     if (handle->hexaworld_data.hexaworld) {
         // generate ALL the LAYERS !
-        generate_world(handle->hexaworld_data.hexaworld);
+        generate_world(handle->hexaworld_data.hexaworld, handle->hexaworld_data.generation_budget, handle->hexaworld_data.storage);
     }
     
     return handle;
@@ -191,6 +228,8 @@ void hexaworld_raylib_app_deinit(hexaworld_raylib_app_handle_t **hexapp) {
 
     info_panel_destroy(&((*hexapp)->hexaworld_data.linked_panel));
     hexaworld_destroy(&((*hexapp)->hexaworld_data.hexaworld));
+    hexaworld_pool_destroy(&((*hexapp)->world_pool));
+    taskpool_destroy(&((*hexapp)->pool));
 
     if (IsWindowReady()) {
         CloseWindow();
@@ -205,6 +244,7 @@ void hexaworld_raylib_app_deinit(hexaworld_raylib_app_handle_t **hexapp) {
 // -------------------------------------------------------------------------------------------------
 void hexaworld_raylib_app_run(hexaworld_raylib_app_handle_t *hexapp, u32 target_fps) {
     i32 new_seed = 0;
+    hexaworld_t *new_world = NULL;
 
     if (!IsWindowReady() || (!hexapp) || (!hexapp->hexaworld_data.hexaworld)) {
         return;
@@ -220,8 +260,15 @@ void hexaworld_raylib_app_run(hexaworld_raylib_app_handle_t *hexapp, u32 target_
 
         if (IsKeyPressed(KEY_ENTER) && IsKeyDown(KEY_LEFT_SHIFT)) {
             new_seed = rand();
-            hexaworld_reseed(hexapp->hexaworld_data.hexaworld, new_seed);
-            generate_world(hexapp->hexaworld_data.hexaworld);
+            // the world is given back and taken again razed, with its memory and topology as they were
+            hexaworld_pool_give(hexapp->world_pool, &(hexapp->hexaworld_data.hexaworld));
+            new_world = hexaworld_pool_take(hexapp->world_pool, hexapp->hexaworld_data.world_width, hexapp->hexaworld_data.world_height, new_seed);
+            if (!new_world) {
+                end_of_the_line(END_OF_THE_LINE_EXIT_NO_MEMORY, "could not allocate the regenerated world");
+            }
+            hexaworld_set_coarse_levels(new_world, hexapp->hexaworld_data.coarse_levels);
+            hexapp->hexaworld_data.hexaworld = new_world;
+            generate_world(hexapp->hexaworld_data.hexaworld, hexapp->hexaworld_data.generation_budget, hexapp->hexaworld_data.storage);
 
             info_panel_set_map_seed(hexapp->hexaworld_data.linked_panel, new_seed);
             info_panel_set_examined_cell(hexapp->hexaworld_data.linked_panel, NULL, 0u, 0u);
@@ -272,12 +319,29 @@ static void application_end_of_the_line_destroy(void *raw_ptr_app) {
 }
 
 // -------------------------------------------------------------------------------------------------
-static void generate_world(hexaworld_t *world) {
-    hexaworld_raze(world);
-    
+static void generate_world(hexaworld_t *world, f64 budget, hexaworld_storage_t storage) {
+    hexaworld_generation_report_t report = { 0u };
+
+    hexaworld_generate(world, budget, &report);
+    // only when asked to : a settled world shows what its form keeps, and is rebuilt from scratch by the next generation
+    if (storage != HEXAW_STORAGE_DENSE) {
+        hexaworld_settle(world, storage);
+    }
+
+    if ((report.degraded_layers == 0u) && (report.added_coarse_levels == 0u) && (!report.budget_missed)) {
+        return;
+    }
+
+    printf("world generated in %.1f ms for a budget of %.1f ms, on %u added coarser level(s)", report.elapsed, budget, report.added_coarse_levels);
     for (size_t i_layer = 0u ; i_layer < HEXAW_LAYERS_NUMBER ; i_layer++) {
-        hexaworld_genlayer(world, i_layer);
+        if (report.degraded_layers & ((flag_set32_t) 1u << i_layer)) {
+            printf(", layer %lu stopped at %u/%u iterations", i_layer, report.iterations_done[i_layer], report.iterations_wanted[i_layer]);
+        }
+    }
+    if (report.budget_missed) {
+        printf(", budget missed with a predicted floor of %.1f ms", report.predicted_floor);
     }
+    printf("\n");
 }
 
 // -------------------------------------------------------------------------------------------------
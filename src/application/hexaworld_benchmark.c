@@ -0,0 +1,910 @@
+/**
+ * @file hexaworld_benchmark.c
+ * @author gabriel 
+ * @brief definition file for the hexaworld benchmark.
+ * @version 0.1
+ * @date 2023-04-24
+ * 
+ * @copyright Copyright (c) 2023
+ * 
+ */
+#include <hexaworld_benchmark.h>
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <raylib.h>
+
+#include <cellotomaton.h>
+#include <endoftheline.h>
+#include <taskpool.h>
+
+#include "hexaworld/hexaworld.h"
+#include "hexaworld/hexaworldpool.h"
+#include "hexaworld/worldcomponents/hexaworldcomponents.h"
+
+// -------------------------------------------------------------------------------------------------
+// ---- FILE CONSTANTS -----------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+#define FAILURE_MESSAGE_SIZE (128u) ///< size of the message printed when the world cannot be allocated
+
+#define LATITUDE_BANDS_NB (8u)                  ///< number of bands of rows the climates of two worlds are compared on
+#define LATITUDE_TEMPERATURE_TOLERANCE (5.0)    ///< largest difference between the mean temperatures of a band, in degrees, for two climates to be close
+#define LATITUDE_WINDS_TOLERANCE (0.5)          ///< largest distance between the mean winds of a band, the winds being of magnitude 1 at most, for two climates to be close
+
+#define KERNELS_DISK_RADIUS (4u)            ///< radius of the disks of tiles whose altitudes are summed by the benchmark
+#define KERNELS_FILTER_RADIUS (2u)          ///< radius of the box filter the benchmark runs on the altitudes
+#define KERNELS_FILTER_TOLERANCE (1e-3)     ///< largest difference between a filtered altitude and its mean computed tile by tile
+
+#define BUDGET_OVERRUN_TOLERANCE (1.5)      ///< largest ratio between the time a generation took and the longest of its budget and its predicted floor
+#define PACKING_STEPS_TOLERANCE (0.51)      ///< largest error of a packed number, in steps of its fixed point : half a step, and what the floats round on the way
+#define PACKING_LIMIT_CELLS_NB (4u)         ///< number of cells packed with their fields at or around their limits
+
+/// names of the traversal orders, as printed in the benchmark's table
+static const char *traversal_names[OTOMATON_TRAVERSALS_NB] = {
+        [OTOMATON_TRAVERSAL_ROWS]   = "rows",
+        [OTOMATON_TRAVERSAL_TILES]  = "tiles",
+        [OTOMATON_TRAVERSAL_MORTON] = "morton",
+};
+
+// -------------------------------------------------------------------------------------------------
+// ---- FILE TYPES ---------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Climate of a world, as the means of its temperatures and winds over each band of rows.
+ */
+typedef struct latitude_climate_t {
+    /// mean temperature of each band, in degrees
+    f64 temperatures[LATITUDE_BANDS_NB];
+    /// mean wind of each band, as cartesian coordinates
+    vector_2d_cartesian_t winds[LATITUDE_BANDS_NB];
+} latitude_climate_t;
+
+/**
+ * @brief Cell of the automaton the benchmark measures its neighborhood kernels on.
+ */
+typedef struct kernels_cell_t {
+    /// number read by the kernels
+    f32 value;
+    /// sum of the disk around the cell, written by a disk function
+    f32 disk_sum;
+} kernels_cell_t;
+
+/**
+ * @brief Times taken by the neighborhood kernels of the automaton, against the same results computed naively.
+ */
+typedef struct kernels_report_t {
+    /// milliseconds taken to sum each disk tile by tile
+    f64 naive_disk_time;
+    /// milliseconds taken by `otomaton_disk_sums()`
+    f64 disk_sums_time;
+    /// milliseconds taken by `otomaton_apply_disk()` summing each disk
+    f64 apply_disk_time;
+    /// number of tiles whose sums differ from the naive ones, from either kernel
+    size_t disk_mismatches_nb;
+    /// milliseconds taken to average the box around each tile, tile by tile
+    f64 naive_filter_time;
+    /// milliseconds taken by `otomaton_filter()` with a box kernel
+    f64 filter_time;
+    /// largest difference between a filtered number and its naive mean
+    f64 filter_difference;
+    /// 1 if the kernels could be run, 0 if their memory could not be allocated
+    u32 was_run;
+} kernels_report_t;
+
+/**
+ * @brief How far packed cells come back from the ones they were packed from.
+ */
+typedef struct packing_report_t {
+    /// worst error of the 16-bit ratios (cloud cover, precipitations) against the ratios clamped between 0 and 1, in steps
+    f64 ratio16_steps;
+    /// worst error of the 8-bit ratios (winds magnitude, vegetation) against the ratios clamped between 0 and 1, in steps
+    f64 ratio8_steps;
+    /// worst error of the winds' angles, around the circle, in steps
+    f64 angle_steps;
+    /// number of cells whose other fields did not come back exactly
+    size_t inexact_cells_nb;
+    /// memory taken by the world in the dense form, before it was packed, in bytes
+    size_t dense_footprint;
+    /// memory taken by the packed tiles of the world, in bytes
+    size_t packed_footprint;
+    /// 1 if the cells were packed, 0 if their memory could not be allocated
+    u32 was_run;
+} packing_report_t;
+
+/**
+ * @brief How the tiles of a world settled in the sparse form come back, and what they take.
+ */
+typedef struct sparse_report_t {
+    /// number of tiles with a field not coming back bit for bit
+    size_t inexact_tiles_nb;
+    /// number of ocean tiles of the world
+    size_t ocean_tiles_nb;
+    /// memory taken by the world in the dense form, in bytes
+    size_t dense_footprint;
+    /// memory the tiles of the world take in the sparse form, in bytes
+    size_t sparse_footprint;
+    /// 1 if the world was settled, 0 if its memory could not be allocated
+    u32 was_run;
+} sparse_report_t;
+
+// -------------------------------------------------------------------------------------------------
+// ---- STATIC FUNCTIONS DECLARATIONS --------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Returns the time elapsed since an arbitrary point, in milliseconds.
+ * 
+ * @return f64 monotonic time in milliseconds
+ */
+static f64 benchmark_now(void);
+
+/**
+ * @brief Measures the climate of a world whose temperature and winds layers were generated.
+ * 
+ * @param[in] world measured world
+ * @param[out] climate outgoing means of each band of rows
+ */
+static void benchmark_measure_climate(hexaworld_t *world, latitude_climate_t *climate);
+
+/**
+ * @brief Prints how far a climate is from a reference one, band of rows by band of rows.
+ * 
+ * @param[in] name name of the compared generation, as printed
+ * @param[in] reference climate of the world generated at its full size
+ * @param[in] climate compared climate
+ * @return u32 1 if every band is within the tolerances, 0 otherwise
+ */
+static u32 benchmark_compare_climates(const char *name, const latitude_climate_t *reference, const latitude_climate_t *climate);
+
+/**
+ * @brief Runs the neighborhood kernels of the automaton on the altitudes of a generated world, and the same
+ * computations tile by tile to check them against.
+ * 
+ * @param[in] world generated world
+ * @param[in] pool pool running the kernels
+ * @param[out] report outgoing timings and mismatches
+ */
+static void benchmark_kernels(hexaworld_t *world, task_pool_t *pool, kernels_report_t *report);
+
+/**
+ * @brief Reads every field of a world in the dense form through its field views, and checks them against its tiles.
+ * 
+ * @param[in] world generated world
+ * @return size_t number of fields of tiles read differently through the views, every field counted if a view is missing
+ */
+static size_t benchmark_field_views(const hexaworld_t *world);
+
+/**
+ * @brief Packs cells whose fields are at, or right around, the limits of what they can hold.
+ * 
+ * @param[out] report outgoing errors of the packed cells
+ */
+static void benchmark_packing_limits(packing_report_t *report);
+
+/**
+ * @brief Settles a generated world in the sparse form, and reads its tiles back to check them, field by field,
+ * against the tiles it had.
+ * 
+ * @param[inout] world generated world, sparse once done
+ * @param[out] report outgoing number of inexact tiles and memory they take
+ */
+static void benchmark_sparse(hexaworld_t *world, sparse_report_t *report);
+
+/**
+ * @brief Settles a generated world in the packed form, and reads its tiles back to check them against the tiles it had.
+ * 
+ * @param[inout] world generated world, packed once done
+ * @param[out] report outgoing errors of the packed tiles and memory they take
+ */
+static void benchmark_packing(hexaworld_t *world, packing_report_t *report);
+
+/**
+ * @brief Adds to a report how far a packed cell came back from the cell it was packed from.
+ * 
+ * @param[in] cell cell before being packed
+ * @param[in] unpacked same cell once packed and unpacked
+ * @param[inout] report report keeping the worst errors
+ */
+static void benchmark_compare_packed(const hexa_cell_t *cell, const hexa_cell_t *unpacked, packing_report_t *report);
+
+/**
+ * @brief Sums a number over the disk of tiles around a tile, walking the whole square of axial coordinates around it.
+ * 
+ * @param[in] values numbers of the tiles, row after row
+ * @param[in] width number of columns
+ * @param[in] height number of rows
+ * @param[in] x column of the center of the disk
+ * @param[in] y row of the center of the disk
+ * @param[in] radius radius of the disk
+ * @return f32 sum of the numbers of the disk, its center included
+ */
+static f32 benchmark_naive_disk_sum(const f32 *values, size_t width, size_t height, size_t x, size_t y, size_t radius);
+
+/**
+ * @brief Averages a number over the tiles a box filter reaches from a tile, as the sum of up to some steps along
+ * each of the three axes of the hexagons, walking every combination of steps.
+ * 
+ * @param[in] values numbers of the tiles, row after row
+ * @param[in] width number of columns
+ * @param[in] height number of rows
+ * @param[in] x column of the filtered tile
+ * @param[in] y row of the filtered tile
+ * @param[in] radius number of steps along each axis
+ * @return f64 mean of the numbers reached
+ */
+static f64 benchmark_naive_filter(const f32 *values, size_t width, size_t height, size_t x, size_t y, size_t radius);
+
+/**
+ * @brief Reads the number of a kernels cell.
+ * 
+ * @param[in] cell read cell
+ * @return f32 number of the cell
+ */
+static f32 kernels_cell_value(const void *cell);
+
+/**
+ * @brief Disk function summing the numbers of the disk around a kernels cell.
+ * 
+ * @param[out] target written cell
+ * @param[in] center cell at the center of the disk, as it was before the iteration
+ * @param[in] offsets offsets to the neighbors
+ * @param[in] neighbors_nb number of neighbors
+ */
+static void kernels_cell_disk_sum(void *target, void *center, const i64 *offsets, size_t neighbors_nb);
+
+// -------------------------------------------------------------------------------------------------
+// ---- HEADER FUNCTIONS DEFINITIONS ---------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+// -------------------------------------------------------------------------------------------------
+u32 hexaworld_benchmark(i32 random_seed, u32 world_width, u32 world_height, u32 thread_nb, u32 coarse_levels, f64 generation_budget) {
+    task_pool_t *pool = NULL;
+    hexaworld_pool_t *world_pool = NULL;
+    hexaworld_t *world = NULL;
+    f64 timings[OTOMATON_TRAVERSALS_NB][HEXAW_LAYERS_NUMBER] = { 0u };
+    f64 totals[OTOMATON_TRAVERSALS_NB] = { 0u };
+    f64 start = 0.0;
+    hexaworld_generation_report_t report = { 0u };
+    char failure_message[FAILURE_MESSAGE_SIZE] = { 0u };
+    u32 has_passed = 1u;
+    latitude_climate_t reference_climate = { 0u };
+    latitude_climate_t coarse_climate = { 0u };
+    latitude_climate_t budget_climate = { 0u };
+    kernels_report_t kernels_report = { 0u };
+    packing_report_t limits_report = { 0u };
+    packing_report_t packing_report = { 0u };
+    sparse_report_t sparse_report = { 0u };
+    size_t view_mismatches_nb = 0u;
+
+    pool = taskpool_create(thread_nb);
+    world_pool = hexaworld_pool_create(1u, pool);
+    if ((!pool) || (!world_pool)) {
+        end_of_the_line(END_OF_THE_LINE_EXIT_NO_MEMORY, "could not allocate the benchmark's threads.");
+    }
+
+    // the worlds are generated one after the other, so they do not compete for the pool's threads, and each one
+    // reuses the memory of the one before
+    for (size_t traversal = 0u ; traversal < OTOMATON_TRAVERSALS_NB ; traversal++) {
+        world = hexaworld_pool_take(world_pool, world_width, world_height, random_seed);
+        if (!world) {
+            snprintf(failure_message, sizeof(failure_message), "could not allocate the benchmarked world (%.1f MiB).",
+                    (f64) hexaworld_footprint(world_width, world_height, pool) / (1024.0 * 1024.0));
+            end_of_the_line(END_OF_THE_LINE_EXIT_NO_MEMORY, failure_message);
+        }
+        coarse_levels = hexaworld_set_coarse_levels(world, coarse_levels);
+        hexaworld_set_traversal(world, (otomaton_traversal_t) traversal);
+
+        for (size_t layer = 0u ; layer < HEXAW_LAYERS_NUMBER ; layer++) {
+            start = benchmark_now();
+            hexaworld_genlayer(world, (hexaworld_layer_t) layer);
+            timings[traversal][layer] = benchmark_now() - start;
+            totals[traversal] += timings[traversal][layer];
+        }
+        benchmark_measure_climate(world, &coarse_climate);
+
+        // the kernels are measured on the last world, with the same threads as the layers
+        if (traversal == (OTOMATON_TRAVERSALS_NB - 1u)) {
+            view_mismatches_nb = benchmark_field_views(world);
+            benchmark_kernels(world, pool, &kernels_report);
+        }
+
+        // the last world knows how long its layers take, and can split the budget between them
+        if ((generation_budget > 0.0) && (traversal == (OTOMATON_TRAVERSALS_NB - 1u))) {
+            hexaworld_generate(world, generation_budget, &report);
+            benchmark_measure_climate(world, &budget_climate);
+        }
+
+        // the last world is settled once it is not generated anymore, first in the sparse form then, read through
+        // it, in the packed form, and is generated again from the packed form as the reference world
+        if (traversal == (OTOMATON_TRAVERSALS_NB - 1u)) {
+            benchmark_sparse(world, &sparse_report);
+            benchmark_packing(world, &packing_report);
+        }
+
+        hexaworld_pool_give(world_pool, &world);
+    }
+
+    // the climate the coarser worlds lead to, whether asked for or added to fit in the budget, is checked against
+    // the one of the world generated at its full size
+    if ((coarse_levels > 0u) || (report.coarse_levels > 0u)) {
+        world = hexaworld_pool_take(world_pool, world_width, world_height, random_seed);
+        if (!world) {
+            end_of_the_line(END_OF_THE_LINE_EXIT_NO_MEMORY, "could not allocate the reference world.");
+        }
+        hexaworld_set_coarse_levels(world, 0u);
+        for (size_t layer = 0u ; layer < HEXAW_LAYERS_NUMBER ; layer++) {
+            hexaworld_genlayer(world, (hexaworld_layer_t) layer);
+        }
+        benchmark_measure_climate(world, &reference_climate);
+        hexaworld_pool_give(world_pool, &world);
+    }
+    hexaworld_pool_destroy(&world_pool);
+
+    printf("%ux%u tiles, %lu thread(s), %u coarser level(s), milliseconds per layer\n", world_width, world_height, taskpool_thread_nb(pool), coarse_levels);
+    taskpool_destroy(&pool);
+
+    printf("%-8s", "layer");
+    for (size_t traversal = 0u ; traversal < OTOMATON_TRAVERSALS_NB ; traversal++) {
+        printf("%12s", traversal_names[traversal]);
+    }
+    printf("\n");
+
+    for (size_t layer = 0u ; layer < HEXAW_LAYERS_NUMBER ; layer++) {
+        printf("%-8lu", layer);
+        for (size_t traversal = 0u ; traversal < OTOMATON_TRAVERSALS_NB ; traversal++) {
+            printf("%12.1f", timings[traversal][layer]);
+        }
+        printf("\n");
+    }
+
+    printf("%-8s", "total");
+    for (size_t traversal = 0u ; traversal < OTOMATON_TRAVERSALS_NB ; traversal++) {
+        printf("%12.1f", totals[traversal]);
+    }
+    printf("\n");
+
+    if (kernels_report.was_run) {
+        printf("\ndisks of radius %u, milliseconds : %.1f tile by tile, %.1f summed, %.1f applied, %lu mismatching tile(s)\n",
+                KERNELS_DISK_RADIUS,
+                kernels_report.naive_disk_time,
+                kernels_report.disk_sums_time,
+                kernels_report.apply_disk_time,
+                kernels_report.disk_mismatches_nb);
+        printf("box filter of radius %u, milliseconds : %.1f tile by tile, %.1f filtered, worst difference %.2e\n",
+                KERNELS_FILTER_RADIUS,
+                kernels_report.naive_filter_time,
+                kernels_report.filter_time,
+                kernels_report.filter_difference);
+        has_passed = (kernels_report.disk_mismatches_nb == 0u) && (kernels_report.filter_difference <= KERNELS_FILTER_TOLERANCE);
+    }
+
+    printf("field views, %lu field(s) of tiles read differently\n", view_mismatches_nb);
+    has_passed = (view_mismatches_nb == 0u) && has_passed;
+
+    benchmark_packing_limits(&limits_report);
+    printf("packed cells at the limits of their fields, worst steps : %.3f 16-bit ratios, %.3f 8-bit ratios, %.3f winds angles, %lu inexact cell(s)\n",
+            limits_report.ratio16_steps,
+            limits_report.ratio8_steps,
+            limits_report.angle_steps,
+            limits_report.inexact_cells_nb);
+    has_passed = (limits_report.ratio16_steps <= PACKING_STEPS_TOLERANCE) && (limits_report.ratio8_steps <= PACKING_STEPS_TOLERANCE)
+            && (limits_report.angle_steps <= PACKING_STEPS_TOLERANCE) && (limits_report.inexact_cells_nb == 0u) && has_passed;
+
+    if (sparse_report.was_run) {
+        printf("sparse world, %.1f MiB instead of %.1f MiB, %.1f%% ocean tiles, %lu inexact tile(s)\n",
+                (f64) sparse_report.sparse_footprint / (1024.0 * 1024.0),
+                (f64) sparse_report.dense_footprint / (1024.0 * 1024.0),
+                100.0 * (f64) sparse_report.ocean_tiles_nb / (f64) MAX(world_width * world_height, 1u),
+                sparse_report.inexact_tiles_nb);
+        has_passed = (sparse_report.inexact_tiles_nb == 0u) && has_passed;
+    }
+
+    if (packing_report.was_run) {
+        printf("packed world, %.1f MiB instead of %.1f MiB, worst steps : %.3f 16-bit ratios, %.3f 8-bit ratios, %.3f winds angles, %lu inexact tile(s)\n",
+                (f64) packing_report.packed_footprint / (1024.0 * 1024.0),
+                (f64) packing_report.dense_footprint / (1024.0 * 1024.0),
+                packing_report.ratio16_steps,
+                packing_report.ratio8_steps,
+                packing_report.angle_steps,
+                packing_report.inexact_cells_nb);
+        has_passed = (packing_report.ratio16_steps <= PACKING_STEPS_TOLERANCE) && (packing_report.ratio8_steps <= PACKING_STEPS_TOLERANCE)
+                && (packing_report.angle_steps <= PACKING_STEPS_TOLERANCE) && (packing_report.inexact_cells_nb == 0u) && has_passed;
+    }
+
+    if (coarse_levels > 0u) {
+        has_passed = benchmark_compare_climates("coarse-to-fine", &reference_climate, &coarse_climate) && has_passed;
+    }
+
+    if (generation_budget <= 0.0) {
+        return has_passed;
+    }
+
+    printf("\n%.1f ms for a budget of %.1f ms, predicted floor of %.1f ms, %u coarser level(s) of which %u added\n",
+            report.elapsed, generation_budget, report.predicted_floor, report.coarse_levels, report.added_coarse_levels);
+    printf("%-8s%12s%12s\n", "layer", "wanted", "done");
+    for (size_t layer = 0u ; layer < HEXAW_LAYERS_NUMBER ; layer++) {
+        printf("%-8lu%12u%12u%s\n", layer, report.iterations_wanted[layer], report.iterations_done[layer],
+                (report.degraded_layers & ((flag_set32_t) 1u << layer)) ? "  degraded" : "");
+    }
+
+    // a budget under the floor cannot be met, but the floor itself must be
+    if (report.budget_missed) {
+        printf("budget missed by %.1f ms\n", report.elapsed - generation_budget);
+    }
+    if (report.elapsed > (BUDGET_OVERRUN_TOLERANCE * MAX(generation_budget, report.predicted_floor))) {
+        printf("the generation took more than %.1f times its budget and its predicted floor\n", BUDGET_OVERRUN_TOLERANCE);
+        has_passed = 0u;
+    }
+
+    // layers cut short by the budget change the climate on their own, which the report already tells
+    if ((report.coarse_levels > 0u) && (!benchmark_compare_climates("budget", &reference_climate, &budget_climate)) && (!report.degraded_layers)) {
+        has_passed = 0u;
+    }
+
+    return has_passed;
+}
+
+// -------------------------------------------------------------------------------------------------
+// ---- STATIC FUNCTIONS DEFINITIONS ---------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+// -------------------------------------------------------------------------------------------------
+static f64 benchmark_now(void) {
+    struct timespec now = { 0u };
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((f64) now.tv_sec * 1000.0) + ((f64) now.tv_nsec / 1000000.0);
+}
+
+// -------------------------------------------------------------------------------------------------
+static void benchmark_measure_climate(hexaworld_t *world, latitude_climate_t *climate) {
+    size_t tiles_nb[LATITUDE_BANDS_NB] = { 0u };
+    hexa_cell_t tile = { 0u };
+    size_t band = 0u;
+
+    *climate = (latitude_climate_t) { 0u };
+
+    for (size_t y = 0u ; y < world->height ; y++) {
+        band = (y * LATITUDE_BANDS_NB) / world->height;
+
+        for (size_t x = 0u ; x < world->width ; x++) {
+            tile = hexaworld_tile(world, x, y);
+            climate->temperatures[band] += (f64) tile.temperature;
+            climate->winds[band].v += cosf(tile.winds_vector.angle) * tile.winds_vector.magnitude;
+            climate->winds[band].w += sinf(tile.winds_vector.angle) * tile.winds_vector.magnitude;
+        }
+        tiles_nb[band] += world->width;
+    }
+
+    for (size_t i = 0u ; i < LATITUDE_BANDS_NB ; i++) {
+        if (tiles_nb[i] > 0u) {
+            climate->temperatures[i] /= (f64) tiles_nb[i];
+            climate->winds[i].v /= (f32) tiles_nb[i];
+            climate->winds[i].w /= (f32) tiles_nb[i];
+        }
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static u32 benchmark_compare_climates(const char *name, const latitude_climate_t *reference, const latitude_climate_t *climate) {
+    f64 temperature_difference = 0.0;
+    f64 winds_distance = 0.0;
+    f64 worst_temperature_difference = 0.0;
+    f64 worst_winds_distance = 0.0;
+
+    for (size_t i = 0u ; i < LATITUDE_BANDS_NB ; i++) {
+        temperature_difference = fabs(climate->temperatures[i] - reference->temperatures[i]);
+        winds_distance = hypot(climate->winds[i].v - reference->winds[i].v, climate->winds[i].w - reference->winds[i].w);
+
+        worst_temperature_difference = MAX(worst_temperature_difference, temperature_difference);
+        worst_winds_distance = MAX(worst_winds_distance, winds_distance);
+    }
+
+    printf("\n%s climate against the full size, worst band : %.2f degrees, winds %.3f apart, %s\n",
+            name,
+            worst_temperature_difference,
+            worst_winds_distance,
+            ((worst_temperature_difference <= LATITUDE_TEMPERATURE_TOLERANCE) && (worst_winds_distance <= LATITUDE_WINDS_TOLERANCE)) ? "close" : "FAR");
+
+    return (worst_temperature_difference <= LATITUDE_TEMPERATURE_TOLERANCE) && (worst_winds_distance <= LATITUDE_WINDS_TOLERANCE);
+}
+
+// -------------------------------------------------------------------------------------------------
+static void benchmark_kernels(hexaworld_t *world, task_pool_t *pool, kernels_report_t *report) {
+    const otomaton_capacity_t capacity = { .disk_radius = KERNELS_DISK_RADIUS };
+    const size_t tiles_nb = world->width * world->height;
+
+    cell_automaton_t *automaton = NULL;
+    kernels_cell_t *cells = NULL;
+    f32 *values = NULL;
+    f32 *naive_sums = NULL;
+    f32 *disk_sums = NULL;
+    f64 *naive_means = NULL;
+    hexaworld_field_view_t altitudes = { 0u };
+    size_t pitch = 0u;
+    size_t checked_rows_start = 0u;
+    size_t checked_rows_end = 0u;
+    f64 start = 0.0;
+
+    *report = (kernels_report_t) { 0u };
+
+    automaton = otomaton_create_with(world->width, world->height, sizeof(kernels_cell_t), &capacity, pool);
+    values = malloc(MAX(tiles_nb, 1u) * sizeof(*values));
+    naive_sums = malloc(MAX(tiles_nb, 1u) * sizeof(*naive_sums));
+    disk_sums = malloc(MAX(tiles_nb, 1u) * sizeof(*disk_sums));
+    naive_means = malloc(MAX(tiles_nb, 1u) * sizeof(*naive_means));
+    // contengency
+    if ((!automaton) || (!values) || (!naive_sums) || (!disk_sums) || (!naive_means)) {
+        otomaton_destroy(&automaton);
+        free(values);
+        free(naive_sums);
+        free(disk_sums);
+        free(naive_means);
+        return;
+    }
+
+    // the altitudes are whole numbers, so every way of summing them gives the same floats
+    altitudes = hexaworld_field_view(world, HEXAW_FIELD_ALTITUDE);
+    cells = (kernels_cell_t *) otomaton_array(automaton, &pitch);
+    for (size_t y = 0u ; y < world->height ; y++) {
+        for (size_t x = 0u ; x < world->width ; x++) {
+            values[(y * world->width) + x] = (f32) *((const alt_m_t *) (altitudes.base + (y * altitudes.row_pitch) + (x * altitudes.stride)));
+            ((kernels_cell_t *) ((u8 *) cells + (y * pitch)))[x] = (kernels_cell_t) { .value = values[(y * world->width) + x] };
+        }
+    }
+
+    start = benchmark_now();
+    for (size_t y = 0u ; y < world->height ; y++) {
+        for (size_t x = 0u ; x < world->width ; x++) {
+            naive_sums[(y * world->width) + x] = benchmark_naive_disk_sum(values, world->width, world->height, x, y, KERNELS_DISK_RADIUS);
+        }
+    }
+    report->naive_disk_time = benchmark_now() - start;
+
+    start = benchmark_now();
+    otomaton_disk_sums(automaton, KERNELS_DISK_RADIUS, &kernels_cell_value, disk_sums);
+    report->disk_sums_time = benchmark_now() - start;
+
+    start = benchmark_now();
+    otomaton_apply_disk(automaton, 1u, KERNELS_DISK_RADIUS, &kernels_cell_disk_sum, 0u, 0.0f);
+    report->apply_disk_time = benchmark_now() - start;
+
+    cells = (kernels_cell_t *) otomaton_array(automaton, &pitch);
+    for (size_t y = 0u ; y < world->height ; y++) {
+        for (size_t x = 0u ; x < world->width ; x++) {
+            report->disk_mismatches_nb += (disk_sums[(y * world->width) + x] != naive_sums[(y * world->width) + x])
+                    || (((kernels_cell_t *) ((u8 *) cells + (y * pitch)))[x].disk_sum != naive_sums[(y * world->width) + x]);
+        }
+    }
+
+    start = benchmark_now();
+    for (size_t y = 0u ; y < world->height ; y++) {
+        for (size_t x = 0u ; x < world->width ; x++) {
+            naive_means[(y * world->width) + x] = benchmark_naive_filter(values, world->width, world->height, x, y, KERNELS_FILTER_RADIUS);
+        }
+    }
+    report->naive_filter_time = benchmark_now() - start;
+
+    start = benchmark_now();
+    otomaton_filter(automaton, offsetof(kernels_cell_t, value), OTOMATON_SCALAR_F32, OTOMATON_FILTER_BOX, KERNELS_FILTER_RADIUS);
+    report->filter_time = benchmark_now() - start;
+
+    // with an odd number of rows, the rows do not shift the same way on both sides of the north and south edges,
+    // so the lines of the filter and the steps of the naive mean only agree away from them
+    checked_rows_end = world->height;
+    if ((world->height & 0x01) && (world->height > (4u * KERNELS_FILTER_RADIUS))) {
+        checked_rows_start = 2u * KERNELS_FILTER_RADIUS;
+        checked_rows_end = world->height - (2u * KERNELS_FILTER_RADIUS);
+    } else if (world->height & 0x01) {
+        checked_rows_end = 0u;
+    }
+
+    cells = (kernels_cell_t *) otomaton_array(automaton, &pitch);
+    for (size_t y = checked_rows_start ; y < checked_rows_end ; y++) {
+        for (size_t x = 0u ; x < world->width ; x++) {
+            report->filter_difference = MAX(report->filter_difference,
+                    fabs((f64) ((kernels_cell_t *) ((u8 *) cells + (y * pitch)))[x].value - naive_means[(y * world->width) + x]));
+        }
+    }
+    report->was_run = 1u;
+
+    otomaton_destroy(&automaton);
+    free(values);
+    free(naive_sums);
+    free(disk_sums);
+    free(naive_means);
+}
+
+// -------------------------------------------------------------------------------------------------
+static size_t benchmark_field_views(const hexaworld_t *world) {
+    hexaworld_field_view_t view = { 0u };
+    hexa_cell_t tile = { 0u };
+    size_t offset = 0u;
+    size_t size = 0u;
+    size_t mismatches_nb = 0u;
+
+    for (size_t i = 0u ; i < HEXAW_FIELDS_NB ; i++) {
+        view = hexaworld_field_view(world, (hexa_cell_field_t) i);
+        hexa_cell_field_span((hexa_cell_field_t) i, &offset, &size);
+
+        // contengency
+        if ((!view.base) || (view.element_size != size) || (view.width != world->width) || (view.height != world->height)) {
+            mismatches_nb += world->width * world->height;
+            continue;
+        }
+
+        for (size_t y = 0u ; y < world->height ; y++) {
+            for (size_t x = 0u ; x < world->width ; x++) {
+                tile = hexaworld_tile(world, x, y);
+                mismatches_nb += (memcmp(view.base + (y * view.row_pitch) + (x * view.stride), (const u8 *) &tile + offset, size) != 0);
+            }
+        }
+    }
+
+    return mismatches_nb;
+}
+
+// -------------------------------------------------------------------------------------------------
+static void benchmark_packing_limits(packing_report_t *report) {
+    const f32 telluric_step = PI_T_2 / (f32) HEXA_PACKED_DIRECTIONS_NB;
+    const hexa_cell_t cells[PACKING_LIMIT_CELLS_NB] = {
+            // every field at its lowest
+            {
+                    .telluric_vector = { .angle = 0.0f, .magnitude = 0.0f },
+                    .winds_vector = { .angle = 0.0f, .magnitude = 0.0f },
+                    .freshwater_direction = DIRECTION_E,
+                    .cloud_cover = 0.0f, .precipitations = 0.0f, .vegetation_cover = 0.0f, .vegetation_trees = 0.0f,
+                    .flags = 0u, .freshwater_height = 0u, .altitude = INT16_MIN, .temperature = INT8_MIN,
+                    .freshwater_sources_directions = 0u,
+            },
+            // every field at its highest, the angles right before a whole turn
+            {
+                    .telluric_vector = { .angle = (f32) (HEXA_PACKED_DIRECTIONS_NB - 1u) * telluric_step, .magnitude = 1.0f },
+                    .winds_vector = { .angle = nextafterf(PI_T_2, 0.0f), .magnitude = 1.0f },
+                    .freshwater_direction = DIRECTION_NE,
+                    .cloud_cover = 1.0f, .precipitations = 1.0f, .vegetation_cover = 1.0f, .vegetation_trees = 1.0f,
+                    .flags = (flag_set32_t) ((1u << HEXAW_FLAGS_NB) - 1u), .freshwater_height = UINT16_MAX, .altitude = INT16_MAX, .temperature = INT8_MAX,
+                    .freshwater_sources_directions = (flag_set8_t) ((1u << DIRECTIONS_NB) - 1u),
+            },
+            // the smallest steps away from the limits, the ratios right inside them
+            {
+                    .telluric_vector = { .angle = telluric_step, .magnitude = 1.0f },
+                    .winds_vector = { .angle = angle_from_fixed16(1u) / 2.0f, .magnitude = nextafterf(1.0f, 0.0f) },
+                    .freshwater_direction = DIRECTION_SE,
+                    .cloud_cover = nextafterf(0.0f, 1.0f), .precipitations = nextafterf(1.0f, 0.0f),
+                    .vegetation_cover = ratio_from_fixed8(1u) / 2.0f, .vegetation_trees = 1.0f - (ratio_from_fixed8(1u) / 2.0f),
+                    .flags = 0x01u, .freshwater_height = 1u, .altitude = -1, .temperature = -1,
+                    .freshwater_sources_directions = 0x01u,
+            },
+            // the ratios and angles right outside the limits, clamped or wrapped around
+            {
+                    .telluric_vector = { .angle = PI_T_2, .magnitude = 1.0f },
+                    .winds_vector = { .angle = -angle_from_fixed16(1u) / 4.0f, .magnitude = 1.04f },
+                    .freshwater_direction = DIRECTION_W,
+                    .cloud_cover = -0.04f, .precipitations = 1.5f, .vegetation_cover = -0.0f, .vegetation_trees = nextafterf(1.0f, 2.0f),
+                    .flags = 0x80000000u, .freshwater_height = UINT16_MAX - 1u, .altitude = 1, .temperature = 1,
+                    .freshwater_sources_directions = 0x20u,
+            },
+    };
+
+    hexa_cell_packed_t packed = { 0u };
+    hexa_cell_t unpacked = { 0u };
+
+    *report = (packing_report_t) { 0u };
+
+    for (size_t i = 0u ; i < PACKING_LIMIT_CELLS_NB ; i++) {
+        hexa_cell_pack(cells + i, &packed);
+        hexa_cell_unpack(&packed, &unpacked);
+        benchmark_compare_packed(cells + i, &unpacked, report);
+    }
+    report->was_run = 1u;
+}
+
+// -------------------------------------------------------------------------------------------------
+static void benchmark_sparse(hexaworld_t *world, sparse_report_t *report) {
+    hexa_cell_t *tiles = NULL;
+    hexa_cell_t tile = { 0u };
+    size_t offset = 0u;
+    size_t size = 0u;
+    u32 is_exact = 1u;
+
+    *report = (sparse_report_t) { 0u };
+
+    tiles = malloc(MAX(world->width * world->height, 1u) * sizeof(*tiles));
+    // contengency
+    if (!tiles) {
+        return;
+    }
+
+    for (size_t y = 0u ; y < world->height ; y++) {
+        for (size_t x = 0u ; x < world->width ; x++) {
+            tiles[(y * world->width) + x] = hexaworld_tile(world, x, y);
+            report->ocean_tiles_nb += (tiles[(y * world->width) + x].altitude <= 0.0f);
+        }
+    }
+
+    report->dense_footprint = hexaworld_footprint(world->width, world->height, world->pool);
+    if (!hexaworld_settle(world, HEXAW_STORAGE_SPARSE)) {
+        free(tiles);
+        return;
+    }
+    report->sparse_footprint = hexaworld_tiles_footprint(world);
+
+    // the fields are compared one by one, the padding between them being left as it falls
+    for (size_t y = 0u ; y < world->height ; y++) {
+        for (size_t x = 0u ; x < world->width ; x++) {
+            tile = hexaworld_tile(world, x, y);
+            is_exact = 1u;
+            for (size_t i = 0u ; i < HEXAW_FIELDS_NB ; i++) {
+                hexa_cell_field_span((hexa_cell_field_t) i, &offset, &size);
+                is_exact = is_exact && (memcmp((const u8 *) &tile + offset, (const u8 *) (tiles + (y * world->width) + x) + offset, size) == 0);
+            }
+            report->inexact_tiles_nb += !is_exact;
+        }
+    }
+    report->was_run = 1u;
+
+    free(tiles);
+}
+
+// -------------------------------------------------------------------------------------------------
+static void benchmark_packing(hexaworld_t *world, packing_report_t *report) {
+    hexa_cell_t *tiles = NULL;
+    hexa_cell_t unpacked = { 0u };
+
+    *report = (packing_report_t) { 0u };
+
+    tiles = malloc(MAX(world->width * world->height, 1u) * sizeof(*tiles));
+    // contengency
+    if (!tiles) {
+        return;
+    }
+
+    for (size_t y = 0u ; y < world->height ; y++) {
+        for (size_t x = 0u ; x < world->width ; x++) {
+            tiles[(y * world->width) + x] = hexaworld_tile(world, x, y);
+        }
+    }
+
+    report->dense_footprint = hexaworld_footprint(world->width, world->height, world->pool);
+    if (!hexaworld_settle(world, HEXAW_STORAGE_PACKED)) {
+        free(tiles);
+        return;
+    }
+    report->packed_footprint = hexaworld_tiles_footprint(world);
+
+    for (size_t y = 0u ; y < world->height ; y++) {
+        for (size_t x = 0u ; x < world->width ; x++) {
+            unpacked = hexaworld_tile(world, x, y);
+            benchmark_compare_packed(tiles + (y * world->width) + x, &unpacked, report);
+        }
+    }
+    report->was_run = 1u;
+
+    free(tiles);
+}
+
+// -------------------------------------------------------------------------------------------------
+static void benchmark_compare_packed(const hexa_cell_t *cell, const hexa_cell_t *unpacked, packing_report_t *report) {
+    const f32 ratios16[2u][2u] = {
+            { cell->cloud_cover,    unpacked->cloud_cover },
+            { cell->precipitations, unpacked->precipitations },
+    };
+    const f32 ratios8[3u][2u] = {
+            { cell->winds_vector.magnitude, unpacked->winds_vector.magnitude },
+            { cell->vegetation_cover,       unpacked->vegetation_cover },
+            { cell->vegetation_trees,       unpacked->vegetation_trees },
+    };
+    f64 angle_difference = 0.0;
+
+    // the ratios come back between 0 and 1 whatever they were
+    for (size_t i = 0u ; i < 2u ; i++) {
+        report->ratio16_steps = MAX(report->ratio16_steps,
+                fabs((f64) ratios16[i][1u] - (f64) MIN(MAX(ratios16[i][0u], 0.0f), 1.0f)) / (f64) ratio_from_fixed16(1u));
+    }
+    for (size_t i = 0u ; i < 3u ; i++) {
+        report->ratio8_steps = MAX(report->ratio8_steps,
+                fabs((f64) ratios8[i][1u] - (f64) MIN(MAX(ratios8[i][0u], 0.0f), 1.0f)) / (f64) ratio_from_fixed8(1u));
+    }
+
+    // the angles come back within a turn, so they are compared around the circle
+    angle_difference = fmod(fabs((f64) unpacked->winds_vector.angle - (f64) cell->winds_vector.angle), (f64) PI_T_2);
+    angle_difference = MIN(angle_difference, (f64) PI_T_2 - angle_difference);
+    report->angle_steps = MAX(report->angle_steps, angle_difference / (f64) angle_from_fixed16(1u));
+
+    report->inexact_cells_nb += (unpacked->telluric_vector.angle != fmodf(cell->telluric_vector.angle, PI_T_2))
+            || (unpacked->telluric_vector.magnitude != cell->telluric_vector.magnitude)
+            || (unpacked->freshwater_direction != cell->freshwater_direction)
+            || (unpacked->flags != cell->flags)
+            || (unpacked->freshwater_height != cell->freshwater_height)
+            || (unpacked->altitude != cell->altitude)
+            || (unpacked->temperature != cell->temperature)
+            || (unpacked->freshwater_sources_directions != cell->freshwater_sources_directions);
+}
+
+// -------------------------------------------------------------------------------------------------
+static f32 benchmark_naive_disk_sum(const f32 *values, size_t width, size_t height, size_t x, size_t y, size_t radius) {
+    const i64 r = (i64) radius;
+
+    f32 sum = 0.0f;
+    i64 rows = 0;
+    i64 row = 0;
+    i64 column = 0;
+
+    for (i64 dr = -r ; dr <= r ; dr++) {
+        for (i64 dq = -r ; dq <= r ; dq++) {
+            // the third axial coordinate is -dq - dr, and must be within the radius too
+            if (((dq + dr) > r) || ((dq + dr) < -r)) {
+                continue;
+            }
+
+            // even rows are shifted west : a column is gained every two rows, rounded towards the north
+            rows = (i64) (y & 0x01) + dr;
+            row = (i64) y + dr;
+            column = (i64) x + dq + ((rows - (rows < 0)) / 2);
+            row = ((row % (i64) height) + (i64) height) % (i64) height;
+            column = ((column % (i64) width) + (i64) width) % (i64) width;
+
+            sum += values[(row * (i64) width) + column];
+        }
+    }
+
+    return sum;
+}
+
+// -------------------------------------------------------------------------------------------------
+static f64 benchmark_naive_filter(const f32 *values, size_t width, size_t height, size_t x, size_t y, size_t radius) {
+    const i64 r = (i64) radius;
+
+    f64 sum = 0.0;
+    i64 dq = 0;
+    i64 dr = 0;
+    i64 rows = 0;
+    i64 row = 0;
+    i64 column = 0;
+
+    // a steps east, b steps south-east and c steps south-west, as axial coordinates
+    for (i64 a = -r ; a <= r ; a++) {
+        for (i64 b = -r ; b <= r ; b++) {
+            for (i64 c = -r ; c <= r ; c++) {
+                dq = a - c;
+                dr = b + c;
+
+                // even rows are shifted west : a column is gained every two rows, rounded towards the north
+                rows = (i64) (y & 0x01) + dr;
+                row = (i64) y + dr;
+                column = (i64) x + dq + ((rows - (rows < 0)) / 2);
+                row = ((row % (i64) height) + (i64) height) % (i64) height;
+                column = ((column % (i64) width) + (i64) width) % (i64) width;
+
+                sum += (f64) values[(row * (i64) width) + column];
+            }
+        }
+    }
+
+    return sum / (f64) (((2 * r) + 1) * ((2 * r) + 1) * ((2 * r) + 1));
+}
+
+// -------------------------------------------------------------------------------------------------
+static f32 kernels_cell_value(const void *cell) {
+    return ((const kernels_cell_t *) cell)->value;
+}
+
+// -------------------------------------------------------------------------------------------------
+static void kernels_cell_disk_sum(void *target, void *center, const i64 *offsets, size_t neighbors_nb) {
+    f32 sum = ((kernels_cell_t *) center)->value;
+
+    for (size_t i = 0u ; i < neighbors_nb ; i++) {
+        sum += ((kernels_cell_t *) OTOMATON_DISK_NEIGHBOR((u8 *) center, offsets, i))->value;
+    }
+
+    ((kernels_cell_t *) target)->disk_sum = sum;
+}
@@ -9,6 +9,12 @@
  * 
  */
 #include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <math.h>
+#include <time.h>
+#include <sys/mman.h>
+
 #include <cellotomaton.h>
 
 // -------------------------------------------------------------------------------------------------
@@ -16,53 +22,269 @@
 // -------------------------------------------------------------------------------------------------
 
 #define PENDULUM_ARRAY_PAIR_NB (2u)   ///< I actually fail to think of a use case where this number isn't 2.
+#define HALO_WIDTH (1u)     ///< number of cells mirrored around the edges of a pendulum buffer, unless the automaton is created for wider disks
+#define ROW_PARITIES_NB (2u)    ///< even and odd rows
+#define FRONTIER_CELLS_MAX (0xFFFFFFFFu)    ///< maximum number of cells of an array tracked by a frontier
+#define TILE_CACHE_SIZE (256u * 1024u)      ///< bytes of the L2 cache a tile of both pendulum buffers can take up
+#define BANDS_PER_THREAD (4u)               ///< bands of rows for each thread of the pool, so idle threads have some left to steal
+#define TIME_BLOCK_CACHE_SIZE (8u * 1024u * 1024u)  ///< bytes of the last-level cache the rows swept by a time block can take up
+#define CELL_COLORS_NB (3u)                 ///< colors needed so no two neighboring hexagons share one
+#define FILTER_AXES_NB (3u)                 ///< axes of the hexagons a filter runs along
+#define FILTER_GAUSSIAN_MEANS_NB (3u)       ///< running means along each axis approaching a gaussian kernel
+#define ARENA_ALIGNMENT (64u)               ///< alignment of each part carved from an arena, a cache line
+#define HUGE_PAGE_SIZE (2u * 1024u * 1024u) ///< size of a huge page, from which an arena is mapped from the system
+
+/// size of a part carved from an arena, rounded up so the next part starts aligned
+#define ARENA_ALIGN(_size) (((_size) + ARENA_ALIGNMENT - 1u) & ~((size_t) ARENA_ALIGNMENT - 1u))
+
+/// address of the cell at the coordinates (x, y) of a target array
+#define ARRAY_CELL(_array, _x, _y) ((_array)->tiles + ((_y) * (_array)->pitch) + ((_x) * (_array)->stride))
 
 // -------------------------------------------------------------------------------------------------
 // ---- TYPE DEFINITIONS ---------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 
 /**
- * @brief Data about an array handled by the automaton.
+ * @brief Data about an array held by the automaton.
  */
 typedef struct target_array_t {
-    /// anonymous array of pointers to the array's data
-    void **tiles;
-    /// number of columns, in number of sub arrays
+    /// anonymous contiguous block of the array's data, stored row after row
+    void *tiles;
+    /// number of columns, in number of elements
     size_t width;
     /// number of rows, in number of elements
     size_t height;
     /// size of the base type, in bytes
     size_t stride;
+    /// distance between the starts of two consecutive rows, in bytes
+    size_t pitch;
 } target_array_t;
 
 /**
- * @brief Pointers to a cell's neighbors.
- */
-typedef struct cell_neighbors_t {
-    /// collection of pointers, one per direction
-    void *neighbors[DIRECTIONS_NB];
-} cell_neighbors_t;
-
-/**
- * @brief A pendulum buffer is a buffer that can also hold data about its neighboring cells.
- * The neighboring cells are usually located in another pendulum buffer so the buffer's changes
- * are not reflected and would influence its current processing.
+ * @brief A pendulum buffer is a buffer surrounded by a ring of cells (the halo) mirroring the opposite edges,
+ * so the world wraps around without any modulo. The neighboring cells of a buffer are read in the other pendulum
+ * buffer so the buffer's changes are not reflected and would influence its current processing.
  */
 typedef struct pendulum_buffer_t {
-    /// buffer's data as a 2d array
+    /// buffer's data as a 2d array, its tiles point to the first cell inside the halo
     target_array_t data;
-    /// map linking each cell's coordinates to its neighbors
-    cell_neighbors_t **neighbors;
+    /// block containing the data and its halo, carved from the automaton's arena
+    void *block;
+    /// number of cells mirrored around each edge
+    size_t halo_width;
 } pendulum_buffer_t;
 
+/**
+ * @brief Single block of memory an automaton and everything it always needs are carved from.
+ */
+typedef struct automaton_arena_t {
+    /// allocated block, starting with the automaton
+    void *block;
+    /// size of the block, in bytes
+    size_t size;
+    /// 1 if the block was mapped from the system, 0 if it comes from the heap
+    u32 is_mapped;
+} automaton_arena_t;
+
+/**
+ * @brief Places, in bytes from the start of an arena, of the parts of an automaton carved from it. The automaton
+ * itself is at the start.
+ */
+typedef struct automaton_layout_t {
+    /// blocks of the pendulum buffers
+    size_t buffers[PENDULUM_ARRAY_PAIR_NB];
+    /// number of pendulum buffers carved, 1 for an automaton changed in place only
+    size_t buffers_nb;
+    /// offsets to the disk of neighbors, for even and odd rows
+    size_t disk_offsets[ROW_PARITIES_NB];
+    /// number of cells mirrored around each edge of the buffers
+    size_t halo_width;
+    /// bands splitting the array
+    size_t bands;
+    /// previous rows of all bands
+    size_t previous_rows;
+    /// number of bands
+    size_t bands_nb;
+    /// cells changed by the last iteration written on each pendulum buffer, for the frontier option, 0 if not carved
+    size_t frontier_changed_cells[PENDULUM_ARRAY_PAIR_NB];
+    /// cells visited by an iteration of the frontier option, 0 if not carved
+    size_t frontier_candidates;
+    /// stamps of the cells made candidates, 0 if not carved
+    size_t frontier_stamps;
+    /// state of the cell visited by the frontier option, 0 if not carved
+    size_t frontier_previous_cell;
+    /// flags of the cells visited with the mask option, 0 if not carved
+    size_t mask_cells;
+    /// runs of the mask, as many as it can have, 0 if not carved
+    size_t mask_runs;
+    /// first run of each row of the mask, 0 if not carved
+    size_t mask_rows_runs;
+    /// size of the whole arena
+    size_t size;
+} automaton_layout_t;
+
+/**
+ * @brief Function applied by the automaton, in one of its three flavors. Exactly one of the three is not NULL.
+ */
+typedef struct automaton_callback_t {
+    /// function applied to each cell, through the per-cell adapter
+    apply_to_cell_func_t cell_function;
+    /// function applied to each row
+    apply_to_row_func_t row_function;
+    /// function applied to each cell along with its disk of neighbors
+    apply_to_disk_func_t disk_function;
+} automaton_callback_t;
+
+/**
+ * @brief Everything needed to apply a function to some cells of the active pendulum buffer during an iteration.
+ */
+typedef struct automaton_sweep_t {
+    /// automaton applying the function
+    struct cell_automaton_t *automaton;
+    /// function applied to the array
+    const automaton_callback_t *callback;
+    /// written-on pendulum buffer
+    pendulum_buffer_t *active_buffer;
+    /// read-from pendulum buffer
+    pendulum_buffer_t *alter_ego;
+    /// wether this is the first iteration of the job
+    u32 is_first_iteration;
+    /// space for a row, used to count the changed cells
+    void *previous_row;
+    /// number of cells changed by the function, not counted if NULL
+    size_t *changed_cells_nb;
+} automaton_sweep_t;
+
+/**
+ * @brief Iteration shared by all the bands of rows submitted to the task pool.
+ */
+typedef struct automaton_job_t {
+    /// function applied to the array
+    const automaton_callback_t *callback;
+    /// index of the written-on pendulum buffer
+    size_t active_buffer_index;
+    /// wether this is the first iteration of the job
+    u32 is_first_iteration;
+    /// set when the bands count their changed cells
+    u32 counts_changes;
+    /// number of iterations run by a time block
+    u32 block_depth;
+    /// number of iterations run by the bands of a wavefront
+    u32 iteration_nb;
+    /// group the tasks of a wavefront are submitted to
+    task_group_t *group;
+    /// color of the cells changed in place by the bands
+    u32 color;
+    /// radius of the disks summed by the bands
+    size_t radius;
+    /// number read from each cell, summed by the bands
+    const f32 *values;
+    /// sum for each cell, written by the bands
+    f32 *sums;
+} automaton_job_t;
+
+/**
+ * @brief Cells changed by the last iterations, so the next ones only visit the cells that might change again.
+ * Cells are designated by their index (y * width + x) in the array.
+ */
+typedef struct automaton_frontier_t {
+    /// cells changed by the last iteration written on each pendulum buffer
+    u32 *changed_cells[PENDULUM_ARRAY_PAIR_NB];
+    /// number of cells changed by the last iteration written on each pendulum buffer
+    size_t changed_cells_nb[PENDULUM_ARRAY_PAIR_NB];
+    /// cells visited by the current iteration
+    u32 *candidates;
+    /// stamp of the last iteration each cell was made a candidate by
+    u32 *stamps;
+    /// stamp of the current iteration
+    u32 stamp;
+    /// state of the visited cell before the function is applied to it
+    void *previous_cell;
+    /// 1 if the tracking is carved from the automaton's arena, and is released with it
+    u32 is_carved;
+} automaton_frontier_t;
+
+/**
+ * @brief Cells visited by the jobs given the mask option, kept as runs of consecutive cells of each row.
+ */
+typedef struct automaton_mask_t {
+    /// one flag for each cell, row after row, set if the cell is visited
+    u8 *cells;
+    /// first column and column after the last one of each run, row after row
+    u32 (*runs)[2u];
+    /// index of the first run of each row, followed by the total number of runs
+    size_t *rows_runs;
+    /// set while a job given the mask option runs
+    u32 in_use;
+    /// set once a mask is built, until it is removed
+    u32 is_set;
+    /// 1 if the room for the mask is carved from the automaton's arena, and is kept from one mask to the next
+    u32 is_carved;
+} automaton_mask_t;
+
+/**
+ * @brief A band of rows of the array, submitted as a task to the pool at each iteration.
+ */
+typedef struct automaton_band_t {
+    /// automaton owning the band
+    struct cell_automaton_t *automaton;
+    /// first row of the band
+    size_t band_start;
+    /// row after the last one of the band
+    size_t band_end;
+    /// state of the row being processed before the function is applied to it, to count the changed cells
+    void *previous_row;
+    /// number of cells of the band changed by the last iteration
+    size_t changed_cells_nb;
+    /// in a wavefront, index of the next iteration run by the band
+    u32 iteration;
+    /// in a wavefront, number of bands around this one (itself included) that have yet to finish the iteration
+    /// before the next one writing on each pendulum buffer
+    atomic_uint pending_bands_nb[PENDULUM_ARRAY_PAIR_NB];
+} automaton_band_t;
+
 /**
  * @brief Definition of a cell automaton data.
  */
 typedef struct cell_automaton_t {
-    /// companion foreign target array, its lifetime is unmanaged by the cell automaton's routines
-    target_array_t target_array;
-    /// two owned pendulum buffers to apply the automaton without any copy
+    /// two owned pendulum buffers to apply the automaton without any copy, one of them is the array seen by the user
     pendulum_buffer_t pendulum_buffers[PENDULUM_ARRAY_PAIR_NB];
+    /// index of the pendulum buffer holding the current state of the array
+    size_t live_buffer_index;
+    /// offsets in bytes from a cell to its neighbors in a pendulum buffer, for even and odd rows
+    i64 neighbor_offsets[ROW_PARITIES_NB][DIRECTIONS_NB];
+    /// changed cells tracking, carved from the arena or allocated the first time the frontier option is used
+    automaton_frontier_t frontier;
+    /// cells visited with the mask option, carved from the arena or allocated when a mask is set
+    automaton_mask_t mask;
+    /// time on the clock of `otomaton_now()` after which no iteration is started, 0 if there is none
+    f64 deadline;
+    /// order in which the cells are visited by the sweeps over bands of rows
+    otomaton_traversal_t traversal;
+    /// side, in number of cells, of the square tiles visited by the tiled traversals
+    size_t tile_side;
+    /// largest number of iterations a time block can run with its rows still in the cache
+    u32 block_depth;
+    /// offsets in bytes from a cell to its disk of neighbors in a pendulum buffer, for even and odd rows, room for the widest disk the halo allows
+    i64 *disk_offsets[ROW_PARITIES_NB];
+    /// radius of the disk of neighbors the offsets were computed for, 0 if they were not
+    size_t disk_radius;
+
+    /// block the automaton, its buffers and its bands are carved from
+    automaton_arena_t arena;
+    /// what the automaton was created able to do
+    otomaton_capacity_t capacity;
+
+    /// pool running the bands, not owned by the automaton
+    task_pool_t *pool;
+    /// iteration currently processed by the bands
+    automaton_job_t job;
+    /// bands splitting the array between them
+    automaton_band_t *bands;
+    /// allocated block containing the previous rows of all bands
+    void *previous_rows;
+    /// number of bands
+    size_t bands_nb;
 } cell_automaton_t;
 
 // -------------------------------------------------------------------------------------------------
@@ -70,221 +292,2226 @@ typedef struct cell_automaton_t {
 // -------------------------------------------------------------------------------------------------
 
 /**
- * @brief Populates an array of anonymous pointers with the neighboring tiles of another defined by its coordinates.
+ * @brief Initializes an allocated pendulum buffer on a block of memory.
  * 
- * @param[out] cell_neighs method-populated array
- * @param[in] x horizontal position of the center tile, in sub-array number
- * @param[in] y vertical position of the center tile, in number of bytes
- * @param[in] array all the tiles as an anonymous array
+ * @param[out] buffer target to-initialize buffer
+ * @param[in] width width, in number of elements of size `stride`
+ * @param[in] height height, in number of elements of size `stride`
+ * @param[in] stride size of an element
+ * @param[in] halo_width number of cells mirrored around each edge
+ * @param[in] block memory of `pendulum_buffer_size()` bytes kept by the caller
  */
-static void get_neighbors(cell_neighbors_t *cell_neighs, size_t x, size_t y, target_array_t *array);
+static void pendulum_buffer_initialize(pendulum_buffer_t *buffer, size_t width, size_t height, size_t stride, size_t halo_width, void *block);
 
 /**
- * @brief Copies the content and size properties of an array to another.
+ * @brief Returns the size of the block of a pendulum buffer, halo included.
  * 
- * @param[out] dest copied-on array
- * @param[in] source copied-out array
+ * @param[in] width width, in number of elements of size `stride`
+ * @param[in] height height, in number of elements of size `stride`
+ * @param[in] stride size of an element
+ * @param[in] halo_width number of cells mirrored around each edge
+ * @return size_t size of the block, in bytes
  */
-static void copy_array(target_array_t *dest, target_array_t *source);
+static size_t pendulum_buffer_size(size_t width, size_t height, size_t stride, size_t halo_width);
 
 /**
- * @brief Initializes an allocated pendulum buffer. This will allocate its internal data to the desired size.
+ * @brief Refreshes the part of the halo of a buffer mirroring a band of rows.
+ * The side cells of each row of the band are mirrored, then the whole first and last rows if they are in the band.
  * 
- * @param[out] buffer target to-initialize buffer
- * @param[in] width width, in number of sub-arrays
- * @param[in] height height, in number of elements of size `stride`
- * @param[in] stride size of an element
+ * @param[inout] buffer initialized buffer
+ * @param[in] band_start first row of the band
+ * @param[in] band_end row after the last row of the band
  */
-static void pendulum_buffer_initialize(pendulum_buffer_t *buffer, size_t width, size_t height, size_t stride);
+static void pendulum_buffer_refresh_halo(pendulum_buffer_t *buffer, size_t band_start, size_t band_end);
 
 /**
- * @brief Refreshes a buffer with some data
+ * @brief Copies a cell of a buffer to the places where the halo mirrors it, if any.
  * 
  * @param[inout] buffer initialized buffer
- * @param[in] source array containing the information. Must be of the same size, height and stride as the buffer.
+ * @param[in] x column of the cell
+ * @param[in] y row of the cell
  */
-static void pendulum_buffer_refresh_from_array(pendulum_buffer_t *buffer, target_array_t source);
+static void pendulum_buffer_mirror_cell(pendulum_buffer_t *buffer, size_t x, size_t y);
 
 /**
- * @brief Link a pendulum buffer to another through its neighbors.
- * The buffer will have its cell's neighbors set to the alter ego's cells.
+ * @brief Computes the offsets from a cell to its neighbors in a pendulum buffer.
  * 
- * @param[inout] buffer initialized buffer
- * @param[in] alter_ego initialized buffer to target
+ * @param[out] offsets offsets for even and odd rows
+ * @param[in] buffer initialized buffer
  */
-static void pendulum_buffer_link_to_alter_ego(pendulum_buffer_t *buffer, pendulum_buffer_t alter_ego);
+static void pendulum_buffer_neighbor_offsets(i64 offsets[ROW_PARITIES_NB][DIRECTIONS_NB], pendulum_buffer_t *buffer);
 
 /**
- * @brief Frees the memory allocated inside a buffer.
+ * @brief Places all the parts of an automaton in its arena.
  * 
- * @param[inout] buffer initialized buffer
+ * @param[out] layout outgoing places of the parts
+ * @param[in] width width, in number of elements of a row
+ * @param[in] height height, in number of rows
+ * @param[in] stride size in bytes of an element
+ * @param[in] capacity what the automaton is able to do
+ * @param[in] pool pool running the bands, can be NULL
+ */
+static void automaton_layout(automaton_layout_t *layout, size_t width, size_t height, size_t stride, const otomaton_capacity_t *capacity, task_pool_t *pool);
+
+/**
+ * @brief Places the buffers and the bands of an automaton in its arena, and sets everything that depends on its
+ * dimensions. The parts placed before the buffers must already be.
+ * 
+ * @param[inout] automaton target automaton, at the start of its arena
+ * @param[in] layout places of the parts, for the given dimensions
+ * @param[in] width width, in number of elements of a row
+ * @param[in] height height, in number of rows
+ * @param[in] stride size in bytes of an element
+ */
+static void automaton_carve(cell_automaton_t *automaton, const automaton_layout_t *layout, size_t width, size_t height, size_t stride);
+
+/**
+ * @brief Allocates the block of an arena. Blocks of at least a huge page are mapped from the system, on huge pages if
+ * some are set aside for it, otherwise on pages it is asked to merge into huge ones.
+ * 
+ * @param[out] arena outgoing arena
+ * @param[in] size size of the block, in bytes
+ * @return u32 1 if the block was allocated, 0 otherwise
+ */
+static u32 automaton_arena_allocate(automaton_arena_t *arena, size_t size);
+
+/**
+ * @brief Gives the block of an arena back.
+ * 
+ * @param[inout] arena allocated arena, not to be used after
+ */
+static void automaton_arena_release(automaton_arena_t *arena);
+
+/**
+ * @brief Applies the automaton's function to the active pendulum buffer, with the threads and in the order
+ * asked by the options.
+ * 
+ * @param[inout] automaton target automaton
+ * @param[in] iteration_nb number of times the function is applied to each cell
+ * @param[in] callback function applied to the array
+ * @param[in] options set of `otomaton_apply_option_t` bit offsets
+ * @param[in] tolerance fraction of changed cells under which an iteration is settled, with the convergence option
+ * @return u32 number of iterations done
+ */
+static u32 automaton_run(cell_automaton_t *automaton, u32 iteration_nb, automaton_callback_t callback, flag_set8_t options, f32 tolerance);
+
+/**
+ * @brief Tells if the automaton's deadline passed, once the first iteration of an application is done.
+ * 
+ * @param[in] automaton checked automaton
+ * @param[in] iterations_done number of iterations the current application went through
+ * @return u32 1 if no more iterations should be started, 0 otherwise
+ */
+static u32 automaton_is_late(const cell_automaton_t *automaton, u32 iterations_done);
+
+/**
+ * @brief Counts the cells that are different between two rows.
+ * 
+ * @param[in] previous_row row before a change
+ * @param[in] row row after a change
+ * @param[in] width number of cells in the rows
+ * @param[in] stride size in bytes of a cell
+ * @return size_t number of different cells
+ */
+static size_t automaton_count_changed_cells(void *previous_row, void *row, size_t width, size_t stride);
+
+/**
+ * @brief Adapter applying a per-cell function to each cell of a row, handing out the cell's neighbors.
+ * 
+ * @param[in] function function applied to each cell
+ * @param[in] offsets offsets in bytes from a cell to its neighbors, for the row's parity
+ * @param[inout] target first cell of the written-on row
+ * @param[in] source first cell of the same row in the read-from buffer
+ * @param[in] width number of cells in the row
+ * @param[in] stride size in bytes of a cell
+ */
+static void automaton_apply_row_per_cell(apply_to_cell_func_t function, i64 offsets[DIRECTIONS_NB], void *target, void *source, size_t width, size_t stride);
+
+/**
+ * @brief Applies a disk function to each cell of a row.
+ * 
+ * @param[in] function function applied to each cell
+ * @param[in] offsets offsets in bytes from a cell to its disk of neighbors, for the row's parity
+ * @param[in] neighbors_nb number of neighbors in the disk
+ * @param[inout] target first cell of the written-on row
+ * @param[in] source first cell of the same row in the read-from buffer
+ * @param[in] width number of cells in the row
+ * @param[in] stride size in bytes of a cell
+ */
+static void automaton_apply_row_per_disk(apply_to_disk_func_t function, const i64 *offsets, size_t neighbors_nb, void *target, void *source, size_t width, size_t stride);
+
+/**
+ * @brief Applies a function once to each cell of a span of a row of the active pendulum buffer, or to the cells of
+ * the span in the mask if one is in use.
+ * On the first iteration of a job, the active buffer does not hold the array's state yet, so the span is copied
+ * from the other buffer right before the function is applied to it.
+ * 
+ * @param[in] sweep current sweep
+ * @param[in] y row of the span
+ * @param[in] x_start first cell of the span
+ * @param[in] x_end cell after the last cell of the span
+ */
+static void automaton_apply_span(const automaton_sweep_t *sweep, size_t y, size_t x_start, size_t x_end);
+
+/**
+ * @brief Applies a function once to each cell of a run of consecutive cells of a row of the active pendulum buffer,
+ * already holding the array's state.
+ * 
+ * @param[in] sweep current sweep
+ * @param[in] y row of the run
+ * @param[in] x_start first cell of the run
+ * @param[in] x_end cell after the last cell of the run
+ */
+static void automaton_apply_run(const automaton_sweep_t *sweep, size_t y, size_t x_start, size_t x_end);
+
+/**
+ * @brief Applies a function once to each cell of a square tile of the active pendulum buffer, row after row.
+ * 
+ * @param[in] sweep current sweep
+ * @param[in] tile_x horizontal index of the tile
+ * @param[in] tile_y vertical index of the tile, from the start of the band
+ * @param[in] band_start first row of the band
+ * @param[in] band_end row after the last row of the band
+ */
+static void automaton_apply_tile(const automaton_sweep_t *sweep, size_t tile_x, size_t tile_y, size_t band_start, size_t band_end);
+
+/**
+ * @brief Extracts one of the two coordinates interleaved in a Morton code.
+ * 
+ * @param[in] code Morton code, shifted by one bit to get the vertical coordinate
+ * @return u32 every other bit of the code, packed together
+ */
+static u32 morton_compact(u64 code);
+
+/**
+ * @brief Applies a function once to each row of a band of rows of the active pendulum buffer, and refreshes
+ * the halo mirroring the band. The cells are visited in the automaton's traversal order.
+ *
+ * @param[inout] automaton target automaton
+ * @param[in] callback function applied to the array
+ * @param[in] active_buffer_index index of the written-on pendulum buffer
+ * @param[in] band_start first row of the band
+ * @param[in] band_end row after the last row of the band
+ * @param[in] is_first_iteration wether this is the first iteration of the job
+ * @param[in] previous_row space for a row, used to count the changed cells
+ * @param[out] changed_cells_nb number of cells changed by the function, not counted if NULL
+ */
+static void automaton_apply_band(cell_automaton_t *automaton, const automaton_callback_t *callback, size_t active_buffer_index, size_t band_start, size_t band_end, u32 is_first_iteration, void *previous_row, size_t *changed_cells_nb);
+
+/**
+ * @brief Applies a function once to each cell of the active pendulum buffer, column after column, and refreshes its halo.
+ * This is the order in which the cells were always visited, so functions drawing from the RNG keep giving the same results.
+ * 
+ * @param[inout] automaton target automaton
+ * @param[in] function function applied to each cell
+ * @param[in] active_buffer_index index of the written-on pendulum buffer
+ * @param[in] is_first_iteration wether this is the first iteration of the job
+ * @param[in] previous_cell space for a cell, used to count the changed cells
+ * @param[out] changed_cells_nb number of cells changed by the function, not counted if NULL
+ */
+static void automaton_apply_column_wise(cell_automaton_t *automaton, apply_to_cell_func_t function, size_t active_buffer_index, u32 is_first_iteration, void *previous_cell, size_t *changed_cells_nb);
+
+/**
+ * @brief Tells if a cell is visited by the current job.
+ * 
+ * @param[in] automaton automaton running the job
+ * @param[in] cell_index index of the cell (y * width + x)
+ * @return u32 1 if the cell is visited, 0 if it is left out by the mask
+ */
+static u32 automaton_visits_cell(const cell_automaton_t *automaton, size_t cell_index);
+
+/**
+ * @brief Releases the mask of an automaton.
+ * 
+ * @param[inout] mask target mask
+ */
+static void automaton_mask_free(automaton_mask_t *mask);
+
+/**
+ * @brief Allocates the frontier of an automaton if it was not already.
+ * 
+ * @param[inout] frontier target frontier
+ * @param[in] cells_nb number of cells in the array
+ * @param[in] stride size in bytes of a cell
+ * @return u32 1 if the frontier can be used, 0 otherwise
+ */
+static u32 automaton_frontier_initialize(automaton_frontier_t *frontier, size_t cells_nb, size_t stride);
+
+/**
+ * @brief Makes a cell a candidate of the current iteration, if it is not already.
+ * 
+ * @param[inout] frontier target frontier
+ * @param[inout] candidates_nb number of candidates of the current iteration
+ * @param[in] cell_index index of the cell
+ */
+static void automaton_frontier_add_candidate(automaton_frontier_t *frontier, size_t *candidates_nb, u32 cell_index);
+
+/**
+ * @brief Applies a function to a single cell of the active pendulum buffer, and remembers the cell if it changed.
+ * 
+ * @param[inout] automaton target automaton
+ * @param[in] function function applied to the cell
+ * @param[in] active_buffer_index index of the written-on pendulum buffer
+ * @param[in] cell_index index of the cell
+ * @param[in] is_first_iteration wether this is the first iteration of the job
+ */
+static void automaton_frontier_visit(cell_automaton_t *automaton, apply_to_cell_func_t function, size_t active_buffer_index, u32 cell_index, u32 is_first_iteration);
+
+/**
+ * @brief Applies a function once to the cells of the active pendulum buffer that might change, and refreshes its halo.
+ * A cell's new state only depends on its state two iterations ago (in the same buffer) and its neighbors' state one
+ * iteration ago (in the other buffer), so only cells changed two iterations ago and neighbors of cells changed by the
+ * last iteration are visited. The first two iterations visit every cell.
+ * 
+ * @param[inout] automaton target automaton, its frontier must be initialized
+ * @param[in] function function applied to the cells
+ * @param[in] active_buffer_index index of the written-on pendulum buffer
+ * @param[in] iteration index of the iteration in the job
+ * @param[out] changed_cells_nb number of cells changed by the function, can be NULL
+ */
+static void automaton_apply_frontier(cell_automaton_t *automaton, apply_to_cell_func_t function, size_t active_buffer_index, u32 iteration, size_t *changed_cells_nb);
+
+/**
+ * @brief Releases the frontier of an automaton.
+ * 
+ * @param[inout] frontier target frontier
+ */
+static void automaton_frontier_free(automaton_frontier_t *frontier);
+
+/**
+ * @brief Applies a function once to each cell of the active pendulum buffer, band after band, the bands being
+ * submitted to the automaton's pool. The calling thread runs bands until all of them are done.
+ *
+ * @param[inout] automaton target automaton
+ * @param[in] callback function applied to the array
+ * @param[in] active_buffer_index index of the written-on pendulum buffer
+ * @param[in] is_first_iteration wether this is the first iteration of the job
+ * @param[out] changed_cells_nb number of cells changed by the function, not counted if NULL
+ */
+static void automaton_apply_bands(cell_automaton_t *automaton, const automaton_callback_t *callback, size_t active_buffer_index, u32 is_first_iteration, size_t *changed_cells_nb);
+
+/**
+ * @brief Task applying the current iteration of an automaton to one of its bands.
+ *
+ * @param[in] raw_band pointer to the band
+ */
+static void automaton_band_run(void *raw_band);
+
+/**
+ * @brief Applies a function several times to each cell of the array, band after band, without waiting for every
+ * band between two iterations. A band runs its next iteration as soon as itself and the two bands around it are done
+ * with the last one : it reads the rows they wrote, and overwrites the rows they read. The calling thread runs bands
+ * until all of them are done with all the iterations.
+ *
+ * @param[inout] automaton target automaton
+ * @param[in] callback function applied to the array
+ * @param[in] active_buffer_index index of the pendulum buffer written on by the first iteration
+ * @param[in] iteration_nb number of iterations run by each band
+ */
+static void automaton_apply_wavefront(cell_automaton_t *automaton, const automaton_callback_t *callback, size_t active_buffer_index, u32 iteration_nb);
+
+/**
+ * @brief Task applying an iteration of the current wavefront to a band, then submitting the next iteration of
+ * the bands around it that are ready for it.
+ *
+ * @param[in] raw_band pointer to the band
+ */
+static void automaton_wavefront_run(void *raw_band);
+
+/**
+ * @brief Applies a function several times to each cell of the array, the iterations being interleaved so each
+ * row is processed as many times as possible while it is in the cache.
+ * Every band first runs the iterations on its rows that only depend on its own rows : the band shrinks by a row on
+ * each side with each iteration, and the rows of an iteration are processed two rows behind the ones of the last
+ * iteration. The rows left on both sides of each boundary between two bands (the first row of the array being the
+ * boundary of the first band) are then processed, iteration after iteration. The same states being computed from
+ * the same states, the results are the same as running the iterations one after the other.
+ *
+ * @param[inout] automaton target automaton, its bands must be at least twice as high as the depth
+ * @param[in] callback function applied to the array
+ * @param[in] active_buffer_index index of the pendulum buffer written on by the first iteration of the block
+ * @param[in] is_first_iteration wether the block starts with the first iteration of the job
+ * @param[in] block_depth number of iterations run by the block
+ */
+static void automaton_apply_time_block(cell_automaton_t *automaton, const automaton_callback_t *callback, size_t active_buffer_index, u32 is_first_iteration, u32 block_depth);
+
+/**
+ * @brief Applies one iteration of the current time block to a row, and refreshes the halo mirroring the row.
+ *
+ * @param[inout] automaton target automaton
+ * @param[in] y processed row
+ * @param[in] iteration index of the iteration in the block, starting at 1
+ */
+static void automaton_block_row(cell_automaton_t *automaton, size_t y, u32 iteration);
+
+/**
+ * @brief Task running the iterations of the current time block that only depend on the rows of a band.
+ *
+ * @param[in] raw_band pointer to the band
+ */
+static void automaton_block_band_run(void *raw_band);
+
+/**
+ * @brief Task running the iterations of the current time block on the rows around the first row of a band.
+ *
+ * @param[in] raw_band pointer to the band
+ */
+static void automaton_block_boundary_run(void *raw_band);
+
+/**
+ * @brief Applies a function once to each cell of the live pendulum buffer, in place. Hexagons can be given one of
+ * three colors so no two neighbors share the same : the cells of each color are changed at the same time, band after
+ * band, then the halo is refreshed before the next color. On a wrapping array, the colors only match across the
+ * edges if the width is a multiple of 3 and the height is even : the cells left out are changed last, one by one.
+ *
+ * @param[inout] automaton target automaton
+ * @param[in] callback function applied to the array, with a per-cell function
+ * @param[out] changed_cells_nb number of cells changed by the function, not counted if NULL
+ */
+static void automaton_apply_colors(cell_automaton_t *automaton, const automaton_callback_t *callback, size_t *changed_cells_nb);
+
+/**
+ * @brief Task changing in place the cells of a band having the color of the current job.
+ *
+ * @param[in] raw_band pointer to the band
+ */
+static void automaton_color_band_run(void *raw_band);
+
+/**
+ * @brief Applies a function in place to a single cell of the live pendulum buffer.
+ *
+ * @param[inout] automaton target automaton
+ * @param[in] function function applied to the cell
+ * @param[in] x column of the cell
+ * @param[in] y row of the cell
+ * @param[in] previous_cell space for a cell, used to count the changed cells
+ * @param[out] changed_cells_nb incremented if the cell changed, not counted if NULL
+ */
+static void automaton_apply_in_place(cell_automaton_t *automaton, apply_to_cell_func_t function, size_t x, size_t y, void *previous_cell, size_t *changed_cells_nb);
+
+/**
+ * @brief Computes the offsets from a cell to its disk of neighbors, if they were computed for another radius.
+ * The disk is walked ring after ring, each ring starting straight to the east and going around clockwise.
+ *
+ * @param[inout] automaton target automaton, its halo must be at least as wide as the radius
+ * @param[in] radius radius of the disk
+ */
+static void automaton_disk_prepare(cell_automaton_t *automaton, size_t radius);
+
+/**
+ * @brief Task summing the disks of the cells of a band, from the numbers and into the sums of the current job.
+ * Each row of a disk is a run of cells : the sum of each run is slid along the row, a number entering it and
+ * another leaving it for each cell.
+ *
+ * @param[in] raw_band pointer to the band
+ */
+static void automaton_disk_sums_band_run(void *raw_band);
+
+/**
+ * @brief Finds how many columns a line of cells along an axis of the hexagons has moved after some steps. The
+ * steps are counted from a start on an even row, so the line crosses the rows the same way on both sides of the
+ * wrapping edges as the neighborhoods of the automaton do.
+ *
+ * @param[in] axis direction along which the line goes
+ * @param[in] step steps from the start of the line, can be negative
+ * @param[in] width number of columns of the array
+ * @return size_t columns moved eastward, wrapped into the row
+ */
+static size_t filter_line_shift(cell_direction_t axis, i64 step, i64 width);
+
+/**
+ * @brief Adds (or subtracts) a row of numbers to the sums of the lines of cells crossing it. The line starting
+ * on a column crosses the row some columns east of it, so the row is read as two contiguous runs, one on each
+ * side of its wrapping edge.
+ *
+ * @param[inout] sums sums of the lines, by the column they start on
+ * @param[in] row numbers of the row
+ * @param[in] width number of columns of the row
+ * @param[in] shift columns between the start of each line and the cell it crosses, already wrapped
+ * @param[in] is_leaving if the row leaves the sums instead of entering them
+ */
+static void filter_rows_slide(f64 *sums, const f32 *row, size_t width, size_t shift, u32 is_leaving);
+
+/**
+ * @brief Replaces each number of a plane by the mean of the numbers up to some cells away from it along an axis.
+ * Along the east axis each row is copied once beside its wrapped ends and the mean is slid along the copy ;
+ * along the other axes every line of cells is slid at once, a whole row entering their sums and another
+ * leaving them with each step. No cell is wrapped in the interior of the rows.
+ *
+ * @param[in] values numbers of the array, row after row
+ * @param[out] filtered means of the array, row after row
+ * @param[in] width number of columns of the array
+ * @param[in] height number of rows of the array
+ * @param[in] axis direction along which the lines of cells go
+ * @param[in] radius number of cells on each side of a cell taken in its mean
+ * @param[out] scratch room for (width + 2 * radius + 1) numbers
+ */
+static void filter_axis(const f32 *values, f32 *filtered, size_t width, size_t height, cell_direction_t axis, size_t radius, f64 *scratch);
+
+/**
+ * @brief Reads a number of some type.
+ *
+ * @param[in] field address of the number
+ * @param[in] type type of the number
+ * @return f32 the number
+ */
+static f32 scalar_read(const void *field, otomaton_scalar_t type);
+
+/**
+ * @brief Writes a number of some type, rounded and clamped to the type.
+ *
+ * @param[out] field address of the number
+ * @param[in] type type of the number
+ * @param[in] value written number
+ */
+static void scalar_write(void *field, otomaton_scalar_t type, f32 value);
+
+/**
+ * @brief Returns the number of bands the rows of an array are split between, more of them than there are threads
+ * in the pool.
+ *
+ * @param[in] height number of rows of the array
+ * @param[in] pool pool running the bands, can be NULL
+ * @return size_t number of bands
+ */
+static size_t automaton_bands_nb(size_t height, task_pool_t *pool);
+
+/**
+ * @brief Splits the array's rows between bands.
+ *
+ * @param[inout] automaton target automaton, its buffers must be initialized
+ * @param[in] bands_nb number of bands, from `automaton_bands_nb()`
+ * @param[out] bands memory for the bands
+ * @param[out] previous_rows memory for a row of each band
  */
-static void pendulum_buffer_free(pendulum_buffer_t *buffer);
+static void automaton_bands_split(cell_automaton_t *automaton, size_t bands_nb, automaton_band_t *bands, void *previous_rows);
 
 // -------------------------------------------------------------------------------------------------
 // ---- HEADER FUNCTIONS DEFINITIONS ---------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 
 // -------------------------------------------------------------------------------------------------
-void otomaton_apply(cell_automaton_t *automaton, u32 iteration_nb, apply_to_cell_func_t function) {
-    target_array_t *target_array = NULL;
-    size_t active_buffer_index = 0u;
-
+u32 otomaton_apply(cell_automaton_t *automaton, u32 iteration_nb, apply_to_cell_func_t function, flag_set8_t options, f32 tolerance) {
     // contengency
-    if ((!automaton) || (!function) || !((automaton->target_array).tiles)) {
-        return;
+    if ((!automaton) || (!function)) {
+        return 0u;
     }
 
-    // shortening accesses
-    target_array = &(automaton->target_array);
-
-    // refreshing buffers to reflect the array's eventual exterior changes
-    for (size_t i = 0 ; i < PENDULUM_ARRAY_PAIR_NB ; i++) {
-        pendulum_buffer_refresh_from_array(automaton->pendulum_buffers + i, *target_array);
+    // a single buffer can only be changed in place
+    if (automaton->capacity.in_place_only) {
+        options |= OTOMATON_OPTION(OTOMATON_OPTION_IN_PLACE);
     }
 
-    // applying the automaton function
-    for (size_t i = 0u ; i < iteration_nb ; i++) {
-        for (size_t x = 0u ; x < target_array->width ; x += 1u) {
-            for (size_t y = 0u ; y < target_array->height ; y += 1u) {
-                function(
-                        automaton->pendulum_buffers[active_buffer_index].data.tiles[x] + y*(target_array->stride), 
-                        automaton->pendulum_buffers[active_buffer_index].neighbors[x][y].neighbors);
-            }
-        }
-
-        // alternating the buffers
-        active_buffer_index = (active_buffer_index + 1u) % PENDULUM_ARRAY_PAIR_NB;
-    }
-    
-    // everything went right (shock, gasp ?) so we commit the last buffer into the target array 
-    copy_array(target_array, &(automaton->pendulum_buffers[(active_buffer_index + 1u) % PENDULUM_ARRAY_PAIR_NB].data));
+    return automaton_run(automaton, iteration_nb, (automaton_callback_t) { .cell_function = function, .row_function = NULL }, options, tolerance);
 }
 
 // -------------------------------------------------------------------------------------------------
-cell_automaton_t *otomaton_create(void **array, size_t width, size_t height, size_t stride) {
-    cell_automaton_t *automaton = NULL;
-
-    automaton = malloc(sizeof(*automaton));
-    if (!automaton) {
-        return NULL;
+u32 otomaton_apply_rows(cell_automaton_t *automaton, u32 iteration_nb, apply_to_row_func_t function, flag_set8_t options, f32 tolerance) {
+    // contengency
+    if ((!automaton) || (!function) || (automaton->capacity.in_place_only)) {
+        return 0u;
     }
 
-    automaton->target_array = (target_array_t) { .tiles = array, .width = width, .height = height, .stride = stride };
+    return automaton_run(automaton, iteration_nb, (automaton_callback_t) { .cell_function = NULL, .row_function = function }, options, tolerance);
+}
 
-    for (size_t i = 0u ; i < PENDULUM_ARRAY_PAIR_NB ; i++) {
-        pendulum_buffer_initialize(automaton->pendulum_buffers + i, width, height, stride);
+// -------------------------------------------------------------------------------------------------
+u32 otomaton_apply_disk(cell_automaton_t *automaton, u32 iteration_nb, size_t radius, apply_to_disk_func_t function, flag_set8_t options, f32 tolerance) {
+    // contengency
+    if ((!automaton) || (!function) || (automaton->capacity.in_place_only)) {
+        return 0u;
     }
-    for (size_t i = 0u ; i < PENDULUM_ARRAY_PAIR_NB ; i++) {
-        pendulum_buffer_link_to_alter_ego(automaton->pendulum_buffers + i, automaton->pendulum_buffers[(i + 1u) % PENDULUM_ARRAY_PAIR_NB]);
+
+    // the halo was made as wide as the automaton's capacity allows
+    if (radius > automaton->pendulum_buffers[0u].halo_width) {
+        return 0u;
     }
+    automaton_disk_prepare(automaton, radius);
 
-    return automaton;
+    return automaton_run(automaton, iteration_nb, (automaton_callback_t) { .disk_function = function }, options, tolerance);
 }
 
 // -------------------------------------------------------------------------------------------------
-void otomaton_destroy(cell_automaton_t **automaton) {
-    if (*automaton) {
-        for (size_t i = 0u ; i < 2u ; i++) {
-            pendulum_buffer_free((*automaton)->pendulum_buffers + i);
+u32 otomaton_disk_sums(cell_automaton_t *automaton, size_t radius, cell_value_func_t value, f32 *out_sums) {
+    target_array_t *live_array = NULL;
+    task_group_t bands_group = { 0u };
+    f32 *values = NULL;
+
+    if ((!automaton) || (!value) || (!out_sums)) {
+        return 0u;
+    }
+
+    live_array = &(automaton->pendulum_buffers[automaton->live_buffer_index].data);
+
+    // each number is read once, and then summed by every disk it is in
+    values = malloc(MAX(live_array->width * live_array->height, 1u) * sizeof(*values));
+    if (!values) {
+        return 0u;
+    }
+    for (size_t y = 0u ; y < live_array->height ; y++) {
+        for (size_t x = 0u ; x < live_array->width ; x++) {
+            values[(y * live_array->width) + x] = value(ARRAY_CELL(live_array, x, y));
         }
+    }
 
-        free(*automaton);
+    automaton->job = (automaton_job_t) { .radius = radius, .values = values, .sums = out_sums };
+    for (size_t i = 0u ; i < automaton->bands_nb ; i++) {
+        taskpool_submit(automaton->pool, &bands_group, &automaton_disk_sums_band_run, automaton->bands + i);
     }
-    *automaton = NULL;
+    taskpool_wait(automaton->pool, &bands_group);
+
+    free(values);
+
+    return 1u;
 }
 
 // -------------------------------------------------------------------------------------------------
-// ---- STATIC FUNCTIONS DEFINITIONS ---------------------------------------------------------------
-// -------------------------------------------------------------------------------------------------
+u32 otomaton_filter(cell_automaton_t *automaton, size_t field_offset, otomaton_scalar_t field_type, otomaton_filter_kernel_t kernel, size_t radius) {
+    static const size_t scalar_sizes[OTOMATON_SCALARS_NB] = {
+            [OTOMATON_SCALAR_F32] = sizeof(f32),
+            [OTOMATON_SCALAR_I8]  = sizeof(i8),
+            [OTOMATON_SCALAR_I16] = sizeof(i16),
+            [OTOMATON_SCALAR_U16] = sizeof(u16),
+    };
+    static const cell_direction_t axes[FILTER_AXES_NB] = { DIRECTION_E, DIRECTION_SE, DIRECTION_SW };
 
-// -------------------------------------------------------------------------------------------------
-static void get_neighbors(cell_neighbors_t *cell_neighs, size_t x, size_t y, target_array_t *array) {
-    size_t coord_w = (x - 1u) * (x > 0) + (array->width - 1u) * (x == 0);
-    size_t coord_e = (x + 1u) % (array->width);
+    target_array_t *live_array = NULL;
+    f32 *values = NULL;
+    f32 *filtered = NULL;
+    f32 *swapped = NULL;
+    f64 *scratch = NULL;
+    size_t means_nb = 0u;
 
-    size_t coord_n = (y - array->stride) * (y > 0) + (array->height*array->stride - array->stride) * (y == 0);
-    size_t coord_s = (y + array->stride) % (array->height*array->stride);
+    // contengency
+    if ((!automaton) || (field_type >= OTOMATON_SCALARS_NB) || (kernel >= OTOMATON_FILTER_KERNELS_NB)) {
+        return 0u;
+    }
 
-    if ((y / array->stride) & 0x01) {
-        // odd row
-        cell_neighs->neighbors[DIRECTION_NW] = array->tiles[x]       + coord_n;
-        cell_neighs->neighbors[DIRECTION_NE] = array->tiles[coord_e] + coord_n;
-        cell_neighs->neighbors[DIRECTION_SW] = array->tiles[x]       + coord_s;
-        cell_neighs->neighbors[DIRECTION_SE] = array->tiles[coord_e] + coord_s;
-    } else {
-        // even row
-        cell_neighs->neighbors[DIRECTION_NW] = array->tiles[coord_w] + coord_n;
-        cell_neighs->neighbors[DIRECTION_NE] = array->tiles[x]       + coord_n;
-        cell_neighs->neighbors[DIRECTION_SW] = array->tiles[coord_w] + coord_s;
-        cell_neighs->neighbors[DIRECTION_SE] = array->tiles[x]       + coord_s;
+    live_array = &(automaton->pendulum_buffers[automaton->live_buffer_index].data);
+    if ((field_offset + scalar_sizes[field_type]) > live_array->stride) {
+        return 0u;
     }
-    
-    cell_neighs->neighbors[DIRECTION_E]  = array->tiles[coord_e] + y;
-    cell_neighs->neighbors[DIRECTION_W]  = array->tiles[coord_w] + y;
-}
 
-// -------------------------------------------------------------------------------------------------
-static void copy_array(target_array_t *dest, target_array_t *source) {
-    dest->width = source->width;
-    dest->height = source->height;
-    dest->stride = source->stride;
+    values = malloc(MAX(live_array->width * live_array->height, 1u) * sizeof(*values));
+    filtered = malloc(MAX(live_array->width * live_array->height, 1u) * sizeof(*filtered));
+    scratch = malloc((live_array->width + (2u * radius) + 1u) * sizeof(*scratch));
+    if ((!values) || (!filtered) || (!scratch)) {
+        free(values);
+        free(filtered);
+        free(scratch);
+        return 0u;
+    }
+
+    for (size_t y = 0u ; y < live_array->height ; y++) {
+        for (size_t x = 0u ; x < live_array->width ; x++) {
+            values[(y * live_array->width) + x] = scalar_read(ARRAY_CELL(live_array, x, y) + field_offset, field_type);
+        }
+    }
+
+    // the means along each axis are applied one after the other, each reading what the last one wrote
+    means_nb = (kernel == OTOMATON_FILTER_GAUSSIAN) ? FILTER_GAUSSIAN_MEANS_NB : 1u;
+    for (size_t i = 0u ; i < means_nb ; i++) {
+        for (size_t j = 0u ; j < FILTER_AXES_NB ; j++) {
+            filter_axis(values, filtered, live_array->width, live_array->height, axes[j], radius, scratch);
+            swapped = values;
+            values = filtered;
+            filtered = swapped;
+        }
+    }
 
-    for (size_t i = 0 ; i < source->width ; i++) {
-        bytewise_copy(dest->tiles[i], source->tiles[i], source->height*source->stride);
+    for (size_t y = 0u ; y < live_array->height ; y++) {
+        for (size_t x = 0u ; x < live_array->width ; x++) {
+            scalar_write(ARRAY_CELL(live_array, x, y) + field_offset, field_type, values[(y * live_array->width) + x]);
+        }
     }
+
+    free(values);
+    free(filtered);
+    free(scratch);
+
+    return 1u;
 }
 
 // -------------------------------------------------------------------------------------------------
-// ---- PENDULUM BUFFER FUNCTIONS  -----------------------------------------------------------------
+cell_automaton_t *otomaton_create(size_t width, size_t height, size_t stride, task_pool_t *pool) {
+    return otomaton_create_with(width, height, stride, NULL, pool);
+}
 
 // -------------------------------------------------------------------------------------------------
-static void pendulum_buffer_initialize(pendulum_buffer_t *buffer, size_t width, size_t height, size_t stride) {
-    // allocating buffer space
-    buffer->data.tiles = malloc(width * sizeof(*(buffer->data.tiles)));
-    for (size_t i = 0u ; i < width ; i++) {
-        buffer->data.tiles[i] = malloc(height * stride);
+cell_automaton_t *otomaton_create_with(size_t width, size_t height, size_t stride, const otomaton_capacity_t *capacity, task_pool_t *pool) {
+    const otomaton_capacity_t given_capacity = (capacity) ? *capacity : (otomaton_capacity_t) { 0u };
+
+    cell_automaton_t *automaton = NULL;
+    automaton_arena_t arena = { 0u };
+    automaton_layout_t layout = { 0u };
+
+    // everything the automaton always needs comes from a single block, so nothing can fail past this point
+    automaton_layout(&layout, width, height, stride, &given_capacity, pool);
+    if (!automaton_arena_allocate(&arena, layout.size)) {
+        return NULL;
     }
-    buffer->data.width = width;
-    buffer->data.height = height;
-    buffer->data.stride = stride;
 
-    // allocating neighbors space
-    buffer->neighbors = malloc(width * sizeof(*(buffer->neighbors)));
-    for (size_t i = 0u ; i < width ; i++) {
-        buffer->neighbors[i] = malloc(height * sizeof(*(buffer->neighbors[i])));
+    automaton = (cell_automaton_t *) arena.block;
+    automaton->arena = arena;
+    automaton->capacity = given_capacity;
+    automaton->pool = pool;
+    automaton->bands = NULL;
+    automaton->bands_nb = 0u;
+    automaton->block_depth = 0u;
+    automaton->disk_radius = 0u;
+    automaton->previous_rows = NULL;
+    automaton->frontier = (automaton_frontier_t) { 0u };
+    automaton->mask = (automaton_mask_t) { 0u };
+
+    // rows are contiguous in memory, and were measured the fastest up to 2048x2048 tiles
+    automaton->traversal = OTOMATON_TRAVERSAL_ROWS;
+    automaton->deadline = 0.0;
+    // largest power of two for a tile of both buffers to fit in the cache
+    automaton->tile_side = 1u;
+    while ((4u * automaton->tile_side * automaton->tile_side * PENDULUM_ARRAY_PAIR_NB * MAX(stride, 1u)) <= TILE_CACHE_SIZE) {
+        automaton->tile_side *= 2u;
     }
 
-    // the function does not return anything, so if a malloc returns null... what ?
+    automaton->disk_offsets[0u] = (i64 *) ((u8 *) arena.block + layout.disk_offsets[0u]);
+    automaton->disk_offsets[1u] = (i64 *) ((u8 *) arena.block + layout.disk_offsets[1u]);
+
+    automaton_carve(automaton, &layout, width, height, stride);
+
+    return automaton;
 }
 
 // -------------------------------------------------------------------------------------------------
-static void pendulum_buffer_link_to_alter_ego(pendulum_buffer_t *buffer, pendulum_buffer_t alter_ego) {
-    for (size_t x = 0u ; x < buffer->data.width ; x++) {
-        for (size_t y = 0u ; y < buffer->data.height ; y++) {
-            get_neighbors(buffer->neighbors[x] + y, x, y*buffer->data.stride, &(alter_ego.data));
-        }
+u32 otomaton_resize(cell_automaton_t **automaton, size_t width, size_t height) {
+    automaton_arena_t arena = { 0u };
+    automaton_arena_t old_arena = { 0u };
+    automaton_layout_t layout = { 0u };
+    size_t stride = 0u;
+
+    if ((!automaton) || (!(*automaton))) {
+        return 0u;
     }
-}
 
-// -------------------------------------------------------------------------------------------------
-static void pendulum_buffer_refresh_from_array(pendulum_buffer_t *buffer, target_array_t source) {
-    copy_array(&(buffer->data), &source);
-}
+    stride = (*automaton)->pendulum_buffers[0u].data.stride;
 
-// -------------------------------------------------------------------------------------------------
-static void pendulum_buffer_free(pendulum_buffer_t *buffer) {
-    for (size_t i = 0u ; i < buffer->data.width ; i++) {
-        free(buffer->neighbors[i]);
+    if (((*automaton)->pendulum_buffers[0u].data.width == width) && ((*automaton)->pendulum_buffers[0u].data.height == height)) {
+        return 1u;
     }
-    free(buffer->neighbors);
 
-    for (size_t i = 0u ; i < buffer->data.width ; i++) {
-        free(buffer->data.tiles[i]);
+    // an arena too small for the new dimensions is traded for a larger one, allocated before anything is released so
+    // the automaton stays usable at its old dimensions if there is not enough memory
+    automaton_layout(&layout, width, height, stride, &((*automaton)->capacity), (*automaton)->pool);
+    if ((layout.size > (*automaton)->arena.size) && (!automaton_arena_allocate(&arena, layout.size))) {
+        return 0u;
     }
-    free(buffer->data.tiles);
 
-    buffer->data.width = 0u;
-    buffer->data.height = 0u;
-    buffer->data.stride = 0u;
-}
\ No newline at end of file
+    // whatever was sized after the old dimensions is given back, to be allocated again when needed, and the disk
+    // offsets change with the pitch
+    (*automaton)->disk_radius = 0u;
+    automaton_frontier_free(&((*automaton)->frontier));
+    automaton_mask_free(&((*automaton)->mask));
+
+    // the automaton and the parts placed before the buffers move along to the larger arena
+    if (arena.block) {
+        memcpy(arena.block, (*automaton)->arena.block, layout.buffers[0u]);
+        *automaton = (cell_automaton_t *) arena.block;
+        // the copied automaton still describes the old arena, released once nothing reads from it
+        old_arena = (*automaton)->arena;
+        (*automaton)->arena = arena;
+        automaton_arena_release(&old_arena);
+        (*automaton)->disk_offsets[0u] = (i64 *) ((u8 *) arena.block + layout.disk_offsets[0u]);
+        (*automaton)->disk_offsets[1u] = (i64 *) ((u8 *) arena.block + layout.disk_offsets[1u]);
+    }
+
+    automaton_carve(*automaton, &layout, width, height, stride);
+
+    return 1u;
+}
+
+// -------------------------------------------------------------------------------------------------
+void otomaton_set_traversal(cell_automaton_t *automaton, otomaton_traversal_t traversal) {
+    if ((!automaton) || (traversal >= OTOMATON_TRAVERSALS_NB)) {
+        return;
+    }
+
+    automaton->traversal = traversal;
+}
+
+// -------------------------------------------------------------------------------------------------
+void otomaton_set_deadline(cell_automaton_t *automaton, f64 deadline) {
+    if (!automaton) {
+        return;
+    }
+
+    automaton->deadline = MAX(deadline, 0.0);
+}
+
+// -------------------------------------------------------------------------------------------------
+f64 otomaton_now(void) {
+    struct timespec now = { 0u };
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((f64) now.tv_sec * 1000.0) + ((f64) now.tv_nsec / 1000000.0);
+}
+
+// -------------------------------------------------------------------------------------------------
+u32 otomaton_set_mask(cell_automaton_t *automaton, cell_predicate_func_t predicate) {
+    target_array_t *live_array = NULL;
+    automaton_mask_t *mask = NULL;
+    size_t runs_nb = 0u;
+    size_t cell_index = 0u;
+
+    if (!automaton) {
+        return 0u;
+    }
+
+    mask = &(automaton->mask);
+    automaton_mask_free(mask);
+
+    if (!predicate) {
+        return 1u;
+    }
+
+    live_array = &(automaton->pendulum_buffers[automaton->live_buffer_index].data);
+
+    // the cells are tested once, the runs being counted along the way so they can be stored right after
+    if (!mask->is_carved) {
+        mask->cells = malloc(MAX(live_array->width * live_array->height, 1u) * sizeof(*(mask->cells)));
+        mask->rows_runs = malloc((live_array->height + 1u) * sizeof(*(mask->rows_runs)));
+        if ((!mask->cells) || (!mask->rows_runs)) {
+            automaton_mask_free(mask);
+            return 0u;
+        }
+    }
+
+    for (size_t y = 0u ; y < live_array->height ; y++) {
+        for (size_t x = 0u ; x < live_array->width ; x++) {
+            cell_index = (y * live_array->width) + x;
+            mask->cells[cell_index] = (predicate(ARRAY_CELL(live_array, x, y)) != 0u);
+            runs_nb += (mask->cells[cell_index] && ((x == 0u) || !mask->cells[cell_index - 1u]));
+        }
+    }
+
+    // the carved room holds as many runs as a mask can have
+    if (!mask->is_carved) {
+        mask->runs = malloc(MAX(runs_nb, 1u) * sizeof(*(mask->runs)));
+        if (!mask->runs) {
+            automaton_mask_free(mask);
+            return 0u;
+        }
+    }
+
+    runs_nb = 0u;
+    for (size_t y = 0u ; y < live_array->height ; y++) {
+        mask->rows_runs[y] = runs_nb;
+
+        for (size_t x = 0u ; x < live_array->width ; x++) {
+            cell_index = (y * live_array->width) + x;
+            if (!mask->cells[cell_index]) {
+                continue;
+            }
+
+            if ((x == 0u) || !mask->cells[cell_index - 1u]) {
+                mask->runs[runs_nb][0u] = (u32) x;
+                runs_nb += 1u;
+            }
+            mask->runs[runs_nb - 1u][1u] = (u32) (x + 1u);
+        }
+    }
+    mask->rows_runs[live_array->height] = runs_nb;
+    mask->is_set = 1u;
+
+    return 1u;
+}
+
+// -------------------------------------------------------------------------------------------------
+void *otomaton_array(cell_automaton_t *automaton, size_t *out_pitch) {
+    target_array_t *live_array = NULL;
+
+    if (!automaton) {
+        return NULL;
+    }
+
+    live_array = &(automaton->pendulum_buffers[automaton->live_buffer_index].data);
+
+    if (out_pitch) {
+        *out_pitch = live_array->pitch;
+    }
+
+    return live_array->tiles;
+}
+
+// -------------------------------------------------------------------------------------------------
+void otomaton_destroy(cell_automaton_t **automaton) {
+    automaton_arena_t arena = { 0u };
+
+    if (*automaton) {
+        // the arena holds the automaton itself
+        arena = (*automaton)->arena;
+
+        automaton_frontier_free(&((*automaton)->frontier));
+        automaton_mask_free(&((*automaton)->mask));
+
+        automaton_arena_release(&arena);
+    }
+    *automaton = NULL;
+}
+
+// -------------------------------------------------------------------------------------------------
+size_t otomaton_footprint(size_t width, size_t height, size_t stride, const otomaton_capacity_t *capacity, task_pool_t *pool) {
+    const otomaton_capacity_t given_capacity = (capacity) ? *capacity : (otomaton_capacity_t) { 0u };
+
+    automaton_layout_t layout = { 0u };
+
+    automaton_layout(&layout, width, height, stride, &given_capacity, pool);
+
+    return layout.size;
+}
+
+// -------------------------------------------------------------------------------------------------
+// ---- STATIC FUNCTIONS DEFINITIONS ---------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+// -------------------------------------------------------------------------------------------------
+// ---- PENDULUM BUFFER FUNCTIONS  -----------------------------------------------------------------
+
+// -------------------------------------------------------------------------------------------------
+static void pendulum_buffer_initialize(pendulum_buffer_t *buffer, size_t width, size_t height, size_t stride, size_t halo_width, void *block) {
+    const size_t pitch = (width + (2u * halo_width)) * stride;
+
+    buffer->block = block;
+    buffer->data.tiles = buffer->block + (halo_width * pitch) + (halo_width * stride);
+    buffer->halo_width = halo_width;
+    buffer->data.width = width;
+    buffer->data.height = height;
+    buffer->data.stride = stride;
+    buffer->data.pitch = pitch;
+}
+
+// -------------------------------------------------------------------------------------------------
+static void pendulum_buffer_refresh_halo(pendulum_buffer_t *buffer, size_t band_start, size_t band_end) {
+    target_array_t *data = &(buffer->data);
+    const size_t halo_size = buffer->halo_width * data->stride;
+    const size_t padded_row_size = (data->width + (2u * buffer->halo_width)) * data->stride;
+
+    size_t source_row = 0u;
+
+    // west and east sides first, so the corners are carried by the row copies. A halo wider than the array
+    // mirrors it more than once
+    for (size_t y = band_start ; y < band_end ; y++) {
+        for (size_t i = 1u ; i <= buffer->halo_width ; i++) {
+            bytewise_copy(ARRAY_CELL(data, 0u, y) - (i * data->stride), ARRAY_CELL(data, (data->width - (i % data->width)) % data->width, y), data->stride);
+            bytewise_copy(ARRAY_CELL(data, data->width - 1u + i, y), ARRAY_CELL(data, (i - 1u) % data->width, y), data->stride);
+        }
+    }
+
+    for (size_t i = 1u ; i <= buffer->halo_width ; i++) {
+        // the last rows are mirrored above the first one
+        source_row = (data->height - (i % data->height)) % data->height;
+        if ((source_row >= band_start) && (source_row < band_end)) {
+            bytewise_copy(
+                    ARRAY_CELL(data, 0u, 0u) - (i * data->pitch) - halo_size, 
+                    ARRAY_CELL(data, 0u, source_row) - halo_size, 
+                    padded_row_size);
+        }
+        // and the first rows below the last one
+        source_row = (i - 1u) % data->height;
+        if ((source_row >= band_start) && (source_row < band_end)) {
+            bytewise_copy(
+                    ARRAY_CELL(data, 0u, data->height - 1u + i) - halo_size, 
+                    ARRAY_CELL(data, 0u, source_row) - halo_size, 
+                    padded_row_size);
+        }
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static void pendulum_buffer_mirror_cell(pendulum_buffer_t *buffer, size_t x, size_t y) {
+    const target_array_t *data = &(buffer->data);
+    i64 columns[3u] = { (i64) x };
+    i64 rows[3u] = { (i64) y };
+    size_t columns_nb = 1u;
+    size_t rows_nb = 1u;
+
+    // a cell on an edge is mirrored beyond the opposite edge, and in a corner of the halo if on two edges
+    if (x == 0u) {
+        columns[columns_nb++] = (i64) data->width;
+    }
+    if (x == (data->width - 1u)) {
+        columns[columns_nb++] = -1;
+    }
+    if (y == 0u) {
+        rows[rows_nb++] = (i64) data->height;
+    }
+    if (y == (data->height - 1u)) {
+        rows[rows_nb++] = -1;
+    }
+
+    for (size_t i = 0u ; i < rows_nb ; i++) {
+        for (size_t j = 0u ; j < columns_nb ; j++) {
+            if ((i > 0u) || (j > 0u)) {
+                bytewise_copy(
+                        data->tiles + (rows[i] * (i64) data->pitch) + (columns[j] * (i64) data->stride),
+                        ARRAY_CELL(data, x, y),
+                        data->stride);
+            }
+        }
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static void pendulum_buffer_neighbor_offsets(i64 offsets[ROW_PARITIES_NB][DIRECTIONS_NB], pendulum_buffer_t *buffer) {
+    const i64 stride = (i64) buffer->data.stride;
+    const i64 pitch = (i64) buffer->data.pitch;
+
+    for (size_t parity = 0u ; parity < ROW_PARITIES_NB ; parity++) {
+        offsets[parity][DIRECTION_E] =  stride;
+        offsets[parity][DIRECTION_W] = -stride;
+    }
+
+    // even rows are shifted to the west of odd rows
+    offsets[0u][DIRECTION_NW] = -pitch - stride;
+    offsets[0u][DIRECTION_NE] = -pitch;
+    offsets[0u][DIRECTION_SW] =  pitch - stride;
+    offsets[0u][DIRECTION_SE] =  pitch;
+
+    offsets[1u][DIRECTION_NW] = -pitch;
+    offsets[1u][DIRECTION_NE] = -pitch + stride;
+    offsets[1u][DIRECTION_SW] =  pitch;
+    offsets[1u][DIRECTION_SE] =  pitch + stride;
+}
+
+// -------------------------------------------------------------------------------------------------
+static size_t pendulum_buffer_size(size_t width, size_t height, size_t stride, size_t halo_width) {
+    return (width + (2u * halo_width)) * stride * (height + (2u * halo_width));
+}
+
+// -------------------------------------------------------------------------------------------------
+// ---- WORKERS FUNCTIONS  -------------------------------------------------------------------------
+
+// -------------------------------------------------------------------------------------------------
+static u32 automaton_run(cell_automaton_t *automaton, u32 iteration_nb, automaton_callback_t callback, flag_set8_t options, f32 tolerance) {
+    pendulum_buffer_t *live_buffer = NULL;
+    size_t active_buffer_index = 0u;
+    u32 use_frontier = 0u;
+    u32 use_time_blocks = 0u;
+    u32 use_wavefront = 0u;
+    u32 block_depth = 0u;
+    u32 iterations_done = 0u;
+    u32 settled_iterations_nb = 0u;
+
+    const u32 detects_convergence = (options & OTOMATON_OPTION(OTOMATON_OPTION_CONVERGE)) != 0u;
+    size_t changed_cells_nb = 0u;
+    size_t tolerated_changes_nb = 0u;
+
+    // the array might have been changed from the outside since the last time
+    live_buffer = automaton->pendulum_buffers + automaton->live_buffer_index;
+    pendulum_buffer_refresh_halo(live_buffer, 0u, live_buffer->data.height);
+
+    if (detects_convergence) {
+        tolerated_changes_nb = (size_t) (MAX(tolerance, 0.0f) * (f32) (live_buffer->data.width * live_buffer->data.height));
+    }
+
+    // without a mask, every cell is visited anyway
+    automaton->mask.in_use = (options & OTOMATON_OPTION(OTOMATON_OPTION_MASKED)) && (automaton->mask.is_set);
+
+    // a single buffer changed in place has settled as soon as an iteration changes nothing. The other buffer
+    // keeps missing whatever was written
+    if ((options & OTOMATON_OPTION(OTOMATON_OPTION_IN_PLACE)) && (callback.cell_function)) {
+        while ((iterations_done < iteration_nb) && (settled_iterations_nb == 0u) && !automaton_is_late(automaton, iterations_done)) {
+            automaton_apply_colors(automaton, &callback, (detects_convergence) ? &changed_cells_nb : NULL);
+            settled_iterations_nb = (detects_convergence && (changed_cells_nb <= tolerated_changes_nb));
+            iterations_done += 1u;
+        }
+
+        automaton->mask.in_use = 0u;
+        return iterations_done;
+    }
+
+    // the frontier tracks single cells, and cannot keep the sequential order
+    use_frontier = (options & OTOMATON_OPTION(OTOMATON_OPTION_FRONTIER))
+            && !(options & OTOMATON_OPTION(OTOMATON_OPTION_SEQUENTIAL))
+            && (callback.cell_function)
+            && automaton_frontier_initialize(
+                    &(automaton->frontier),
+                    live_buffer->data.width * live_buffer->data.height,
+                    live_buffer->data.stride);
+
+    // time blocks do not count the changed cells, and keep to the rows traversal
+    use_time_blocks = (options & OTOMATON_OPTION(OTOMATON_OPTION_TIME_BLOCKS))
+            && !(options & (OTOMATON_OPTION(OTOMATON_OPTION_SEQUENTIAL) | OTOMATON_OPTION(OTOMATON_OPTION_FRONTIER)))
+            && !detects_convergence
+            && !(callback.disk_function)
+            && (automaton->deadline == 0.0)
+            && (automaton->block_depth > 1u);
+
+    // bands only wait for the bands around them, which can only be known without counting the changed cells
+    use_wavefront = !use_frontier && !use_time_blocks && !detects_convergence && !(callback.disk_function)
+            && (automaton->deadline == 0.0)
+            && !(options & OTOMATON_OPTION(OTOMATON_OPTION_SEQUENTIAL))
+            && (automaton->bands_nb > 1u) && (iteration_nb > 1u);
+
+    if (use_wavefront) {
+        automaton_apply_wavefront(automaton, &callback, (automaton->live_buffer_index + 1u) % PENDULUM_ARRAY_PAIR_NB, iteration_nb);
+        iterations_done = iteration_nb;
+    }
+
+    // applying the automaton function, the first iteration is written in the buffer that is not live.
+    // Both buffers must have settled for the next iterations to change nothing
+    while ((iterations_done < iteration_nb) && (settled_iterations_nb < PENDULUM_ARRAY_PAIR_NB)) {
+        if (automaton_is_late(automaton, iterations_done)) {
+            // the array is left in the last written buffer, whether it settled or not
+            iteration_nb = iterations_done;
+            break;
+        }
+
+        // alternating the buffers
+        active_buffer_index = (automaton->live_buffer_index + 1u + iterations_done) % PENDULUM_ARRAY_PAIR_NB;
+        block_depth = (use_time_blocks) ? MIN(automaton->block_depth, iteration_nb - iterations_done) : 1u;
+
+        if (block_depth > 1u) {
+            automaton_apply_time_block(automaton, &callback, active_buffer_index, (iterations_done == 0u), block_depth);
+        } else if (use_frontier) {
+            automaton_apply_frontier(automaton, callback.cell_function, active_buffer_index, iterations_done, &changed_cells_nb);
+        } else if (!(options & OTOMATON_OPTION(OTOMATON_OPTION_SEQUENTIAL))) {
+            automaton_apply_bands(automaton, &callback, active_buffer_index, (iterations_done == 0u), (detects_convergence) ? &changed_cells_nb : NULL);
+        } else if (callback.cell_function) {
+            // cells can only be visited in their order, on the calling thread
+            automaton_apply_column_wise(automaton, callback.cell_function, active_buffer_index, (iterations_done == 0u), automaton->bands->previous_row, (detects_convergence) ? &changed_cells_nb : NULL);
+        } else {
+            // and rows too
+            automaton_apply_band(automaton, &callback, active_buffer_index, 0u, live_buffer->data.height, (iterations_done == 0u), automaton->bands->previous_row, (detects_convergence) ? &changed_cells_nb : NULL);
+        }
+
+        if (detects_convergence) {
+            settled_iterations_nb = (changed_cells_nb <= tolerated_changes_nb) ? (settled_iterations_nb + 1u) : 0u;
+        }
+        iterations_done += MAX(block_depth, 1u);
+    }
+
+    // everything went right (shock, gasp ?) so the last written buffer becomes the array. Once both buffers
+    // settled, the remaining iterations would only swing from one to the other, so the buffer the last one
+    // would have been written in is picked
+    automaton->live_buffer_index = (automaton->live_buffer_index + iteration_nb) % PENDULUM_ARRAY_PAIR_NB;
+    automaton->mask.in_use = 0u;
+
+    return iterations_done;
+}
+
+// -------------------------------------------------------------------------------------------------
+static u32 automaton_is_late(const cell_automaton_t *automaton, u32 iterations_done) {
+    return (automaton->deadline > 0.0) && (iterations_done > 0u) && (otomaton_now() >= automaton->deadline);
+}
+
+// -------------------------------------------------------------------------------------------------
+static size_t automaton_count_changed_cells(void *previous_row, void *row, size_t width, size_t stride) {
+    size_t changed_cells_nb = 0u;
+
+    // most rows did not change at all
+    if (memcmp(previous_row, row, width * stride) == 0) {
+        return 0u;
+    }
+
+    for (size_t x = 0u ; x < width ; x++) {
+        changed_cells_nb += (memcmp(previous_row + (x * stride), row + (x * stride), stride) != 0);
+    }
+
+    return changed_cells_nb;
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_apply_row_per_cell(apply_to_cell_func_t function, i64 offsets[DIRECTIONS_NB], void *target, void *source, size_t width, size_t stride) {
+    void *neighbors[DIRECTIONS_NB] = { NULL };
+
+    for (size_t x = 0u ; x < width ; x += 1u) {
+        for (size_t i = 0u ; i < DIRECTIONS_NB ; i++) {
+            neighbors[i] = source + offsets[i];
+        }
+        function(target, neighbors);
+
+        target += stride;
+        source += stride;
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_apply_row_per_disk(apply_to_disk_func_t function, const i64 *offsets, size_t neighbors_nb, void *target, void *source, size_t width, size_t stride) {
+    for (size_t x = 0u ; x < width ; x += 1u) {
+        function(target, source, offsets, neighbors_nb);
+
+        target += stride;
+        source += stride;
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_apply_span(const automaton_sweep_t *sweep, size_t y, size_t x_start, size_t x_end) {
+    const automaton_mask_t *mask = &(sweep->automaton->mask);
+
+    // the cells left out by the mask are read as neighbors, so they are brought up to date all the same
+    if (sweep->is_first_iteration) {
+        bytewise_copy(
+                ARRAY_CELL(&(sweep->active_buffer->data), x_start, y),
+                ARRAY_CELL(&(sweep->alter_ego->data), x_start, y),
+                (x_end - x_start) * sweep->active_buffer->data.stride);
+    }
+
+    if (!mask->in_use) {
+        automaton_apply_run(sweep, y, x_start, x_end);
+        return;
+    }
+
+    for (size_t i = mask->rows_runs[y] ; i < mask->rows_runs[y + 1u] ; i++) {
+        if ((mask->runs[i][1u] > x_start) && (mask->runs[i][0u] < x_end)) {
+            automaton_apply_run(sweep, y, MAX(mask->runs[i][0u], x_start), MIN(mask->runs[i][1u], x_end));
+        }
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_apply_run(const automaton_sweep_t *sweep, size_t y, size_t x_start, size_t x_end) {
+    const size_t stride = sweep->active_buffer->data.stride;
+    const size_t pitch = sweep->alter_ego->data.pitch;
+    const size_t width = x_end - x_start;
+
+    void *rows[ROW_NEIGHBORHOOD_NB] = { NULL };
+    void *target = NULL;
+
+    target = ARRAY_CELL(&(sweep->active_buffer->data), x_start, y);
+    rows[ROW_CURRENT] = ARRAY_CELL(&(sweep->alter_ego->data), x_start, y);
+    rows[ROW_ABOVE] = rows[ROW_CURRENT] - pitch;
+    rows[ROW_BELOW] = rows[ROW_CURRENT] + pitch;
+
+    if (sweep->changed_cells_nb) {
+        bytewise_copy(sweep->previous_row, target, width * stride);
+    }
+
+    if (sweep->callback->row_function) {
+        sweep->callback->row_function(target, rows, width, (u32) (y & 0x01));
+    } else if (sweep->callback->disk_function) {
+        automaton_apply_row_per_disk(sweep->callback->disk_function, sweep->automaton->disk_offsets[y & 0x01], OTOMATON_DISK_NEIGHBORS_NB(sweep->automaton->disk_radius), target, rows[ROW_CURRENT], width, stride);
+    } else {
+        automaton_apply_row_per_cell(sweep->callback->cell_function, sweep->automaton->neighbor_offsets[y & 0x01], target, rows[ROW_CURRENT], width, stride);
+    }
+
+    if (sweep->changed_cells_nb) {
+        *(sweep->changed_cells_nb) += automaton_count_changed_cells(sweep->previous_row, target, width, stride);
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_apply_tile(const automaton_sweep_t *sweep, size_t tile_x, size_t tile_y, size_t band_start, size_t band_end) {
+    const size_t tile_side = sweep->automaton->tile_side;
+    const size_t x_start = tile_x * tile_side;
+    const size_t x_end = MIN(x_start + tile_side, sweep->active_buffer->data.width);
+    const size_t y_start = band_start + (tile_y * tile_side);
+    const size_t y_end = MIN(y_start + tile_side, band_end);
+
+    for (size_t y = y_start ; y < y_end ; y += 1u) {
+        automaton_apply_span(sweep, y, x_start, x_end);
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static u32 morton_compact(u64 code) {
+    code &= 0x5555555555555555;
+    code = (code | (code >> 1u))  & 0x3333333333333333;
+    code = (code | (code >> 2u))  & 0x0F0F0F0F0F0F0F0F;
+    code = (code | (code >> 4u))  & 0x00FF00FF00FF00FF;
+    code = (code | (code >> 8u))  & 0x0000FFFF0000FFFF;
+    code = (code | (code >> 16u)) & 0x00000000FFFFFFFF;
+
+    return (u32) code;
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_apply_band(cell_automaton_t *automaton, const automaton_callback_t *callback, size_t active_buffer_index, size_t band_start, size_t band_end, u32 is_first_iteration, void *previous_row, size_t *changed_cells_nb) {
+    const automaton_sweep_t sweep = {
+            .automaton = automaton,
+            .callback = callback,
+            .active_buffer = automaton->pendulum_buffers + active_buffer_index,
+            .alter_ego = automaton->pendulum_buffers + ((active_buffer_index + 1u) % PENDULUM_ARRAY_PAIR_NB),
+            .is_first_iteration = is_first_iteration,
+            .previous_row = previous_row,
+            .changed_cells_nb = changed_cells_nb };
+    const size_t width = sweep.active_buffer->data.width;
+    const size_t tiles_nb_x = (width + automaton->tile_side - 1u) / automaton->tile_side;
+    const size_t tiles_nb_y = ((band_end - band_start) + automaton->tile_side - 1u) / automaton->tile_side;
+
+    size_t curve_side = 1u;
+
+    if (changed_cells_nb) {
+        *changed_cells_nb = 0u;
+    }
+
+    switch (automaton->traversal) {
+        case OTOMATON_TRAVERSAL_TILES:
+            for (size_t tile_y = 0u ; tile_y < tiles_nb_y ; tile_y++) {
+                for (size_t tile_x = 0u ; tile_x < tiles_nb_x ; tile_x++) {
+                    automaton_apply_tile(&sweep, tile_x, tile_y, band_start, band_end);
+                }
+            }
+            break;
+
+        case OTOMATON_TRAVERSAL_MORTON:
+            // the curve covers a square with a power of two side, tiles out of the band are skipped
+            while ((curve_side < tiles_nb_x) || (curve_side < tiles_nb_y)) {
+                curve_side *= 2u;
+            }
+            for (u64 code = 0u ; code < (curve_side * curve_side) ; code++) {
+                if ((morton_compact(code) < tiles_nb_x) && (morton_compact(code >> 1u) < tiles_nb_y)) {
+                    automaton_apply_tile(&sweep, morton_compact(code), morton_compact(code >> 1u), band_start, band_end);
+                }
+            }
+            break;
+
+        default:
+            for (size_t y = band_start ; y < band_end ; y += 1u) {
+                automaton_apply_span(&sweep, y, 0u, width);
+            }
+            break;
+    }
+
+    pendulum_buffer_refresh_halo(sweep.active_buffer, band_start, band_end);
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_apply_column_wise(cell_automaton_t *automaton, apply_to_cell_func_t function, size_t active_buffer_index, u32 is_first_iteration, void *previous_cell, size_t *changed_cells_nb) {
+    pendulum_buffer_t *active_buffer = automaton->pendulum_buffers + active_buffer_index;
+    pendulum_buffer_t *alter_ego = automaton->pendulum_buffers + ((active_buffer_index + 1u) % PENDULUM_ARRAY_PAIR_NB);
+    const size_t stride = active_buffer->data.stride;
+
+    void *neighbors[DIRECTIONS_NB] = { NULL };
+    i64 *offsets = NULL;
+    void *cell = NULL;
+    void *mirrored_cell = NULL;
+
+    if (changed_cells_nb) {
+        *changed_cells_nb = 0u;
+    }
+
+    for (size_t x = 0u ; x < active_buffer->data.width ; x += 1u) {
+        for (size_t y = 0u ; y < active_buffer->data.height ; y += 1u) {
+            offsets = automaton->neighbor_offsets[y & 0x01];
+            cell = ARRAY_CELL(&(active_buffer->data), x, y);
+            mirrored_cell = ARRAY_CELL(&(alter_ego->data), x, y);
+
+            for (size_t i = 0u ; i < DIRECTIONS_NB ; i++) {
+                neighbors[i] = mirrored_cell + offsets[i];
+            }
+            if (is_first_iteration) {
+                bytewise_copy(cell, mirrored_cell, active_buffer->data.stride);
+            }
+            if (!automaton_visits_cell(automaton, (y * active_buffer->data.width) + x)) {
+                continue;
+            }
+            if (changed_cells_nb) {
+                bytewise_copy(previous_cell, cell, stride);
+            }
+
+            function(cell, neighbors);
+
+            if (changed_cells_nb) {
+                *changed_cells_nb += (memcmp(previous_cell, cell, stride) != 0);
+            }
+        }
+    }
+
+    pendulum_buffer_refresh_halo(active_buffer, 0u, active_buffer->data.height);
+}
+
+// -------------------------------------------------------------------------------------------------
+static u32 automaton_visits_cell(const cell_automaton_t *automaton, size_t cell_index) {
+    return (!automaton->mask.in_use) || automaton->mask.cells[cell_index];
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_mask_free(automaton_mask_t *mask) {
+    // the room carved from the arena is kept for the next mask
+    if (mask->is_carved) {
+        mask->in_use = 0u;
+        mask->is_set = 0u;
+        return;
+    }
+
+    free(mask->cells);
+    free(mask->runs);
+    free(mask->rows_runs);
+
+    *mask = (automaton_mask_t) { 0u };
+}
+
+// -------------------------------------------------------------------------------------------------
+// ---- FRONTIER FUNCTIONS  ------------------------------------------------------------------------
+
+// -------------------------------------------------------------------------------------------------
+static u32 automaton_frontier_initialize(automaton_frontier_t *frontier, size_t cells_nb, size_t stride) {
+    if (frontier->stamps) {
+        return 1u;
+    }
+
+    if (cells_nb > FRONTIER_CELLS_MAX) {
+        return 0u;
+    }
+
+    for (size_t i = 0u ; i < PENDULUM_ARRAY_PAIR_NB ; i++) {
+        frontier->changed_cells[i] = malloc(sizeof(*(frontier->changed_cells[i])) * cells_nb);
+        frontier->changed_cells_nb[i] = 0u;
+    }
+    frontier->candidates = malloc(sizeof(*(frontier->candidates)) * cells_nb);
+    frontier->stamps = calloc(cells_nb, sizeof(*(frontier->stamps)));
+    frontier->stamp = 0u;
+    frontier->previous_cell = malloc(stride);
+
+    if ((!frontier->changed_cells[0u]) || (!frontier->changed_cells[1u]) || (!frontier->candidates)
+            || (!frontier->stamps) || (!frontier->previous_cell)) {
+        automaton_frontier_free(frontier);
+        return 0u;
+    }
+
+    return 1u;
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_frontier_add_candidate(automaton_frontier_t *frontier, size_t *candidates_nb, u32 cell_index) {
+    if (frontier->stamps[cell_index] == frontier->stamp) {
+        return;
+    }
+
+    frontier->stamps[cell_index] = frontier->stamp;
+    frontier->candidates[*candidates_nb] = cell_index;
+    *candidates_nb += 1u;
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_frontier_visit(cell_automaton_t *automaton, apply_to_cell_func_t function, size_t active_buffer_index, u32 cell_index, u32 is_first_iteration) {
+    automaton_frontier_t *frontier = &(automaton->frontier);
+    pendulum_buffer_t *active_buffer = automaton->pendulum_buffers + active_buffer_index;
+    pendulum_buffer_t *alter_ego = automaton->pendulum_buffers + ((active_buffer_index + 1u) % PENDULUM_ARRAY_PAIR_NB);
+    const size_t x = cell_index % active_buffer->data.width;
+    const size_t y = cell_index / active_buffer->data.width;
+    const size_t stride = active_buffer->data.stride;
+
+    void *neighbors[DIRECTIONS_NB] = { NULL };
+    void *cell = ARRAY_CELL(&(active_buffer->data), x, y);
+    void *mirrored_cell = ARRAY_CELL(&(alter_ego->data), x, y);
+
+    for (size_t i = 0u ; i < DIRECTIONS_NB ; i++) {
+        neighbors[i] = mirrored_cell + automaton->neighbor_offsets[y & 0x01][i];
+    }
+    if (is_first_iteration) {
+        bytewise_copy(cell, mirrored_cell, stride);
+    }
+
+    bytewise_copy(frontier->previous_cell, cell, stride);
+    function(cell, neighbors);
+
+    if (memcmp(frontier->previous_cell, cell, stride) != 0) {
+        frontier->changed_cells[active_buffer_index][frontier->changed_cells_nb[active_buffer_index]] = cell_index;
+        frontier->changed_cells_nb[active_buffer_index] += 1u;
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_apply_frontier(cell_automaton_t *automaton, apply_to_cell_func_t function, size_t active_buffer_index, u32 iteration, size_t *changed_cells_nb) {
+    automaton_frontier_t *frontier = &(automaton->frontier);
+    pendulum_buffer_t *active_buffer = automaton->pendulum_buffers + active_buffer_index;
+    const size_t alter_ego_index = (active_buffer_index + 1u) % PENDULUM_ARRAY_PAIR_NB;
+    const size_t width = active_buffer->data.width;
+    const size_t height = active_buffer->data.height;
+
+    size_t candidates_nb = 0u;
+    size_t x = 0u;
+    size_t y = 0u;
+    size_t vertical_rows[2u] = { 0u };
+    size_t row = 0u;
+    size_t shift = 0u;
+
+    // the buffers do not hold any history yet
+    if (iteration < PENDULUM_ARRAY_PAIR_NB) {
+        frontier->changed_cells_nb[active_buffer_index] = 0u;
+
+        if (!automaton->mask.in_use) {
+            for (u32 i = 0u ; i < (width * height) ; i++) {
+                automaton_frontier_visit(automaton, function, active_buffer_index, i, (iteration == 0u));
+            }
+        } else {
+            // the cells left out by the mask are still read as neighbors, so they are brought up to date first
+            for (y = 0u ; (iteration == 0u) && (y < height) ; y++) {
+                bytewise_copy(
+                        ARRAY_CELL(&(active_buffer->data), 0u, y),
+                        ARRAY_CELL(&(automaton->pendulum_buffers[alter_ego_index].data), 0u, y),
+                        width * active_buffer->data.stride);
+            }
+
+            for (y = 0u ; y < height ; y++) {
+                for (size_t i = automaton->mask.rows_runs[y] ; i < automaton->mask.rows_runs[y + 1u] ; i++) {
+                    for (x = automaton->mask.runs[i][0u] ; x < automaton->mask.runs[i][1u] ; x++) {
+                        automaton_frontier_visit(automaton, function, active_buffer_index, (u32) ((y * width) + x), 0u);
+                    }
+                }
+            }
+        }
+
+        if (changed_cells_nb) {
+            *changed_cells_nb = frontier->changed_cells_nb[active_buffer_index];
+        }
+        pendulum_buffer_refresh_halo(active_buffer, 0u, height);
+        return;
+    }
+
+    // stamps are not cleared between iterations, unless they wrap around
+    frontier->stamp += 1u;
+    if (frontier->stamp == 0u) {
+        memset(frontier->stamps, 0, sizeof(*(frontier->stamps)) * width * height);
+        frontier->stamp = 1u;
+    }
+
+    // cells changed two iterations ago might change again
+    for (size_t i = 0u ; i < frontier->changed_cells_nb[active_buffer_index] ; i++) {
+        automaton_frontier_add_candidate(frontier, &candidates_nb, frontier->changed_cells[active_buffer_index][i]);
+    }
+
+    // and so might the cells having a neighbor changed by the last iteration
+    for (size_t i = 0u ; i < frontier->changed_cells_nb[alter_ego_index] ; i++) {
+        x = frontier->changed_cells[alter_ego_index][i] % width;
+        y = frontier->changed_cells[alter_ego_index][i] / width;
+
+        automaton_frontier_add_candidate(frontier, &candidates_nb, (u32) ((y * width) + ((x + 1u) % width)));
+        automaton_frontier_add_candidate(frontier, &candidates_nb, (u32) ((y * width) + ((x + width - 1u) % width)));
+
+        // an even row sees the cells x - 1 and x of the rows above and below it, an odd row the cells x and x + 1
+        vertical_rows[0u] = (y + height - 1u) % height;
+        vertical_rows[1u] = (y + 1u) % height;
+        for (size_t j = 0u ; j < 2u ; j++) {
+            row = vertical_rows[j];
+            shift = row & 0x01;
+
+            automaton_frontier_add_candidate(frontier, &candidates_nb, (u32) ((row * width) + ((x + width - shift) % width)));
+            automaton_frontier_add_candidate(frontier, &candidates_nb, (u32) ((row * width) + ((x + width - shift + 1u) % width)));
+        }
+    }
+
+    frontier->changed_cells_nb[active_buffer_index] = 0u;
+    for (size_t i = 0u ; i < candidates_nb ; i++) {
+        if (automaton_visits_cell(automaton, frontier->candidates[i])) {
+            automaton_frontier_visit(automaton, function, active_buffer_index, frontier->candidates[i], 0u);
+        }
+    }
+
+    if (changed_cells_nb) {
+        *changed_cells_nb = frontier->changed_cells_nb[active_buffer_index];
+    }
+    pendulum_buffer_refresh_halo(active_buffer, 0u, height);
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_frontier_free(automaton_frontier_t *frontier) {
+    // a frontier carved from the arena is released with it
+    if (frontier->is_carved) {
+        return;
+    }
+
+    for (size_t i = 0u ; i < PENDULUM_ARRAY_PAIR_NB ; i++) {
+        free(frontier->changed_cells[i]);
+    }
+    free(frontier->candidates);
+    free(frontier->stamps);
+    free(frontier->previous_cell);
+
+    *frontier = (automaton_frontier_t) { 0u };
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_apply_bands(cell_automaton_t *automaton, const automaton_callback_t *callback, size_t active_buffer_index, u32 is_first_iteration, size_t *changed_cells_nb) {
+    task_group_t bands_group = { 0u };
+
+    automaton->job = (automaton_job_t) {
+            .callback = callback,
+            .active_buffer_index = active_buffer_index,
+            .is_first_iteration = is_first_iteration,
+            .counts_changes = (changed_cells_nb != NULL) };
+
+    for (size_t i = 0u ; i < automaton->bands_nb ; i++) {
+        taskpool_submit(automaton->pool, &bands_group, &automaton_band_run, automaton->bands + i);
+    }
+
+    // no one reads the other buffer before every band is done writing it
+    taskpool_wait(automaton->pool, &bands_group);
+
+    if (changed_cells_nb) {
+        *changed_cells_nb = 0u;
+        for (size_t i = 0u ; i < automaton->bands_nb ; i++) {
+            *changed_cells_nb += automaton->bands[i].changed_cells_nb;
+        }
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_band_run(void *raw_band) {
+    automaton_band_t *band = (automaton_band_t *) raw_band;
+    const automaton_job_t *job = &(band->automaton->job);
+
+    automaton_apply_band(
+            band->automaton,
+            job->callback,
+            job->active_buffer_index,
+            band->band_start, band->band_end,
+            job->is_first_iteration,
+            band->previous_row,
+            (job->counts_changes) ? &(band->changed_cells_nb) : NULL);
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_apply_wavefront(cell_automaton_t *automaton, const automaton_callback_t *callback, size_t active_buffer_index, u32 iteration_nb) {
+    task_group_t bands_group = { 0u };
+
+    automaton->job = (automaton_job_t) {
+            .callback = callback,
+            .active_buffer_index = active_buffer_index,
+            .is_first_iteration = 1u,
+            .counts_changes = 0u,
+            .iteration_nb = iteration_nb,
+            .group = &bands_group };
+
+    for (size_t i = 0u ; i < automaton->bands_nb ; i++) {
+        automaton->bands[i].iteration = 0u;
+        for (size_t j = 0u ; j < PENDULUM_ARRAY_PAIR_NB ; j++) {
+            atomic_init(automaton->bands[i].pending_bands_nb + j, (u32) MIN(automaton->bands_nb, 3u));
+        }
+    }
+
+    for (size_t i = 0u ; i < automaton->bands_nb ; i++) {
+        taskpool_submit(automaton->pool, &bands_group, &automaton_wavefront_run, automaton->bands + i);
+    }
+
+    // the bands submit each other, the group is only empty once they all ran their last iteration
+    taskpool_wait(automaton->pool, &bands_group);
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_wavefront_run(void *raw_band) {
+    automaton_band_t *band = (automaton_band_t *) raw_band;
+    cell_automaton_t *automaton = band->automaton;
+    const automaton_job_t *job = &(automaton->job);
+    const size_t band_index = (size_t) (band - automaton->bands);
+    const u32 iteration = band->iteration;
+
+    automaton_band_t *neighbor = NULL;
+    size_t neighbors_indexes[3u] = { 0u };
+    const size_t neighbors_nb = MIN(automaton->bands_nb, 3u);
+    const size_t counter_index = (iteration + 1u) % PENDULUM_ARRAY_PAIR_NB;
+
+    automaton_apply_band(
+            automaton,
+            job->callback,
+            (job->active_buffer_index + iteration) % PENDULUM_ARRAY_PAIR_NB,
+            band->band_start, band->band_end,
+            (job->is_first_iteration && (iteration == 0u)),
+            band->previous_row,
+            NULL);
+    band->iteration = iteration + 1u;
+
+    if (band->iteration >= job->iteration_nb) {
+        return;
+    }
+
+    // the band itself, and the bands around it, wrapping around the array
+    neighbors_indexes[0u] = band_index;
+    neighbors_indexes[1u] = (band_index + 1u) % automaton->bands_nb;
+    neighbors_indexes[2u] = (band_index + automaton->bands_nb - 1u) % automaton->bands_nb;
+
+    // the last band done with this iteration submits the next one. The counter is reset before, and cannot be
+    // counted down again before the band is done with the next iteration
+    for (size_t i = 0u ; i < neighbors_nb ; i++) {
+        neighbor = automaton->bands + neighbors_indexes[i];
+        if (atomic_fetch_sub(neighbor->pending_bands_nb + counter_index, 1u) == 1u) {
+            atomic_store(neighbor->pending_bands_nb + counter_index, (u32) neighbors_nb);
+            taskpool_submit(automaton->pool, job->group, &automaton_wavefront_run, neighbor);
+        }
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_apply_time_block(cell_automaton_t *automaton, const automaton_callback_t *callback, size_t active_buffer_index, u32 is_first_iteration, u32 block_depth) {
+    task_group_t bands_group = { 0u };
+
+    automaton->job = (automaton_job_t) {
+            .callback = callback,
+            .active_buffer_index = active_buffer_index,
+            .is_first_iteration = is_first_iteration,
+            .counts_changes = 0u,
+            .block_depth = block_depth };
+
+    for (size_t i = 0u ; i < automaton->bands_nb ; i++) {
+        taskpool_submit(automaton->pool, &bands_group, &automaton_block_band_run, automaton->bands + i);
+    }
+    taskpool_wait(automaton->pool, &bands_group);
+
+    // the rows around a boundary need the rows of both bands, the boundaries being far enough from each other
+    // to be processed at the same time
+    for (size_t i = 0u ; i < automaton->bands_nb ; i++) {
+        taskpool_submit(automaton->pool, &bands_group, &automaton_block_boundary_run, automaton->bands + i);
+    }
+    taskpool_wait(automaton->pool, &bands_group);
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_block_row(cell_automaton_t *automaton, size_t y, u32 iteration) {
+    const automaton_job_t *job = &(automaton->job);
+    const size_t active_buffer_index = (job->active_buffer_index + iteration - 1u) % PENDULUM_ARRAY_PAIR_NB;
+    const automaton_sweep_t sweep = {
+            .automaton = automaton,
+            .callback = job->callback,
+            .active_buffer = automaton->pendulum_buffers + active_buffer_index,
+            .alter_ego = automaton->pendulum_buffers + ((active_buffer_index + 1u) % PENDULUM_ARRAY_PAIR_NB),
+            .is_first_iteration = (job->is_first_iteration && (iteration == 1u)),
+            .previous_row = NULL,
+            .changed_cells_nb = NULL };
+
+    automaton_apply_span(&sweep, y, 0u, sweep.active_buffer->data.width);
+    pendulum_buffer_refresh_halo(sweep.active_buffer, y, y + 1u);
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_block_band_run(void *raw_band) {
+    automaton_band_t *band = (automaton_band_t *) raw_band;
+    const u32 block_depth = band->automaton->job.block_depth;
+    const i64 band_start = (i64) band->band_start;
+    const i64 band_end = (i64) band->band_end;
+
+    i64 y = 0;
+
+    // a row of an iteration needs the row below it from the last iteration, and overwrites the row of the
+    // iteration before, which the rows around it from the last iteration needed : staying two rows behind is enough
+    for (i64 front = band_start ; front < (band_end + (2 * (i64) block_depth)) ; front++) {
+        for (u32 iteration = 1u ; iteration <= block_depth ; iteration++) {
+            y = front - (2 * (i64) iteration);
+            if ((y >= (band_start + (i64) iteration)) && (y < (band_end - (i64) iteration))) {
+                automaton_block_row(band->automaton, (size_t) y, iteration);
+            }
+        }
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_block_boundary_run(void *raw_band) {
+    automaton_band_t *band = (automaton_band_t *) raw_band;
+    const u32 block_depth = band->automaton->job.block_depth;
+    const i64 height = (i64) band->automaton->pendulum_buffers[0u].data.height;
+    const i64 boundary = (i64) band->band_start;
+
+    // the rows left out by both bands, wrapping around the array for the first boundary
+    for (u32 iteration = 1u ; iteration <= block_depth ; iteration++) {
+        for (i64 y = boundary - (i64) iteration ; y < (boundary + (i64) iteration) ; y++) {
+            automaton_block_row(band->automaton, (size_t) ((y + height) % height), iteration);
+        }
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_apply_colors(cell_automaton_t *automaton, const automaton_callback_t *callback, size_t *changed_cells_nb) {
+    pendulum_buffer_t *live_buffer = automaton->pendulum_buffers + automaton->live_buffer_index;
+    const size_t width = live_buffer->data.width;
+    const size_t height = live_buffer->data.height;
+    const size_t colored_width = width - (width % CELL_COLORS_NB);
+    const size_t colored_height = height - (height % ROW_PARITIES_NB);
+
+    task_group_t bands_group = { 0u };
+
+    if (changed_cells_nb) {
+        *changed_cells_nb = 0u;
+    }
+
+    for (u32 color = 0u ; color < CELL_COLORS_NB ; color++) {
+        automaton->job = (automaton_job_t) {
+                .callback = callback,
+                .active_buffer_index = automaton->live_buffer_index,
+                .counts_changes = (changed_cells_nb != NULL),
+                .color = color };
+
+        for (size_t i = 0u ; i < automaton->bands_nb ; i++) {
+            taskpool_submit(automaton->pool, &bands_group, &automaton_color_band_run, automaton->bands + i);
+        }
+        taskpool_wait(automaton->pool, &bands_group);
+
+        // the next color reads what this one wrote, through the halo too
+        pendulum_buffer_refresh_halo(live_buffer, 0u, height);
+
+        if (changed_cells_nb) {
+            for (size_t i = 0u ; i < automaton->bands_nb ; i++) {
+                *changed_cells_nb += automaton->bands[i].changed_cells_nb;
+            }
+        }
+    }
+
+    // cells with a neighbor of the same color across the edges, their changes are mirrored right away
+    for (size_t y = 0u ; y < colored_height ; y++) {
+        for (size_t x = colored_width ; x < width ; x++) {
+            automaton_apply_in_place(automaton, callback->cell_function, x, y, automaton->bands->previous_row, changed_cells_nb);
+            pendulum_buffer_mirror_cell(live_buffer, x, y);
+        }
+    }
+    for (size_t y = colored_height ; y < height ; y++) {
+        for (size_t x = 0u ; x < width ; x++) {
+            automaton_apply_in_place(automaton, callback->cell_function, x, y, automaton->bands->previous_row, changed_cells_nb);
+            pendulum_buffer_mirror_cell(live_buffer, x, y);
+        }
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_color_band_run(void *raw_band) {
+    automaton_band_t *band = (automaton_band_t *) raw_band;
+    cell_automaton_t *automaton = band->automaton;
+    const automaton_job_t *job = &(automaton->job);
+    const size_t width = automaton->pendulum_buffers[0u].data.width;
+    const size_t height = automaton->pendulum_buffers[0u].data.height;
+    const size_t colored_width = width - (width % CELL_COLORS_NB);
+    const size_t colored_height = height - (height % ROW_PARITIES_NB);
+
+    band->changed_cells_nb = 0u;
+
+    // with even rows shifted to the west, the color of (x, y) is (x - y / 2 - y) modulo 3
+    for (size_t y = band->band_start ; y < MIN(band->band_end, colored_height) ; y++) {
+        for (size_t x = (job->color + (y / 2u) + y) % CELL_COLORS_NB ; x < colored_width ; x += CELL_COLORS_NB) {
+            automaton_apply_in_place(automaton, job->callback->cell_function, x, y, band->previous_row, (job->counts_changes) ? &(band->changed_cells_nb) : NULL);
+        }
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_apply_in_place(cell_automaton_t *automaton, apply_to_cell_func_t function, size_t x, size_t y, void *previous_cell, size_t *changed_cells_nb) {
+    pendulum_buffer_t *live_buffer = automaton->pendulum_buffers + automaton->live_buffer_index;
+    const size_t stride = live_buffer->data.stride;
+
+    void *neighbors[DIRECTIONS_NB] = { NULL };
+    void *cell = ARRAY_CELL(&(live_buffer->data), x, y);
+
+    if (!automaton_visits_cell(automaton, (y * live_buffer->data.width) + x)) {
+        return;
+    }
+
+    for (size_t i = 0u ; i < DIRECTIONS_NB ; i++) {
+        neighbors[i] = cell + automaton->neighbor_offsets[y & 0x01][i];
+    }
+
+    if (changed_cells_nb) {
+        bytewise_copy(previous_cell, cell, stride);
+    }
+    function(cell, neighbors);
+    if (changed_cells_nb) {
+        *changed_cells_nb += (memcmp(previous_cell, cell, stride) != 0);
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_disk_prepare(cell_automaton_t *automaton, size_t radius) {
+    // axial steps (along the columns, along the rows) of each direction, in the order of `cell_direction_t`
+    static const i64 steps[DIRECTIONS_NB][2u] = {
+            [DIRECTION_E]  = {  1,  0 },
+            [DIRECTION_SE] = {  0,  1 },
+            [DIRECTION_SW] = { -1,  1 },
+            [DIRECTION_W]  = { -1,  0 },
+            [DIRECTION_NW] = {  0, -1 },
+            [DIRECTION_NE] = {  1, -1 },
+    };
+    const i64 stride = (i64) automaton->pendulum_buffers[0u].data.stride;
+    const i64 pitch = (i64) automaton->pendulum_buffers[0u].data.pitch;
+
+    size_t neighbor = 0u;
+    i64 q = 0;
+    i64 r = 0;
+    i64 shift = 0;
+
+    if (automaton->disk_radius == radius) {
+        return;
+    }
+
+    for (size_t parity = 0u ; parity < ROW_PARITIES_NB ; parity++) {
+        neighbor = 0u;
+        for (i64 ring = 1 ; ring <= (i64) radius ; ring++) {
+            // each ring starts at its eastern corner, and each side goes in the direction two steps after the corner's
+            q = ring;
+            r = 0;
+            for (size_t side = 0u ; side < DIRECTIONS_NB ; side++) {
+                for (i64 i = 0 ; i < ring ; i++) {
+                    // even rows are shifted to the west of odd rows, which shifts the rows between them by half a
+                    // cell : this is (parity + r) / 2 rounded down, kept positive before the division
+                    shift = (((i64) parity + r + (2 * ring)) / 2) - ring;
+                    automaton->disk_offsets[parity][neighbor] = (r * pitch) + ((q + shift) * stride);
+                    neighbor += 1u;
+
+                    q += steps[(side + 2u) % DIRECTIONS_NB][0u];
+                    r += steps[(side + 2u) % DIRECTIONS_NB][1u];
+                }
+            }
+        }
+    }
+
+    automaton->disk_radius = radius;
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_disk_sums_band_run(void *raw_band) {
+    automaton_band_t *band = (automaton_band_t *) raw_band;
+    const automaton_job_t *job = &(band->automaton->job);
+    const i64 width = (i64) band->automaton->pendulum_buffers[0u].data.width;
+    const i64 height = (i64) band->automaton->pendulum_buffers[0u].data.height;
+    const i64 radius = (i64) job->radius;
+
+    const f32 *row_values = NULL;
+    f32 *row_sums = NULL;
+    f64 run_sum = 0.0;
+    i64 shift = 0;
+    i64 run_start = 0;
+    i64 run_end = 0;
+
+    for (i64 y = (i64) band->band_start ; y < (i64) band->band_end ; y++) {
+        row_sums = job->sums + (y * width);
+        for (i64 x = 0 ; x < width ; x++) {
+            row_sums[x] = 0.0f;
+        }
+
+        for (i64 r = -radius ; r <= radius ; r++) {
+            row_values = job->values + ((((y + r) % height) + height) % height) * width;
+
+            // the run of the disk in this row around the cell at x = 0, shifted by half a cell between even and odd rows
+            shift = (((y & 0x01) + r + (2 * radius)) / 2) - radius;
+            run_start = MAX(-radius, -radius - r) + shift;
+            run_end = MIN(radius, radius - r) + shift;
+
+            run_sum = 0.0;
+            for (i64 x = run_start ; x <= run_end ; x++) {
+                run_sum += row_values[((x % width) + width) % width];
+            }
+
+            for (i64 x = 0 ; x < width ; x++) {
+                row_sums[x] += (f32) run_sum;
+                run_sum += row_values[(((x + run_end + 1) % width) + width) % width];
+                run_sum -= row_values[(((x + run_start) % width) + width) % width];
+            }
+        }
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static size_t filter_line_shift(cell_direction_t axis, i64 step, i64 width) {
+    // axial coordinates (columns, rows) of a step along each axis
+    static const i64 axial_steps[DIRECTIONS_NB][2u] = {
+            [DIRECTION_E]  = {  1,  0 },
+            [DIRECTION_SE] = {  0,  1 },
+            [DIRECTION_SW] = { -1,  1 },
+            [DIRECTION_W]  = { -1,  0 },
+            [DIRECTION_NW] = {  0, -1 },
+            [DIRECTION_NE] = {  1, -1 },
+    };
+
+    const i64 rows = axial_steps[axis][1u] * step;
+    // even rows are shifted west : a column is gained every two rows, rounded towards the north
+    const i64 x = (axial_steps[axis][0u] * step) + ((rows - (rows < 0)) / 2);
+
+    return (size_t) (((x % width) + width) % width);
+}
+
+// -------------------------------------------------------------------------------------------------
+static void filter_rows_slide(f64 *sums, const f32 *row, size_t width, size_t shift, u32 is_leaving) {
+    // the lines starting west of (width - shift) cross the row before its east edge, the others after it
+    const size_t split = width - shift;
+
+    if (is_leaving) {
+        for (size_t x = 0u ; x < split ; x++) {
+            sums[x] -= row[x + shift];
+        }
+        for (size_t x = split ; x < width ; x++) {
+            sums[x] -= row[x - split];
+        }
+    } else {
+        for (size_t x = 0u ; x < split ; x++) {
+            sums[x] += row[x + shift];
+        }
+        for (size_t x = split ; x < width ; x++) {
+            sums[x] += row[x - split];
+        }
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static void filter_axis(const f32 *values, f32 *filtered, size_t width, size_t height, cell_direction_t axis, size_t radius, f64 *scratch) {
+    const i64 w = (i64) width;
+    const i64 h = (i64) height;
+    const i64 r = (i64) radius;
+    const f64 cells_nb = (f64) ((2 * r) + 1);
+
+    const f32 *row = NULL;
+    f32 *filtered_row = NULL;
+    size_t shift = 0u;
+    size_t split = 0u;
+    f64 sum = 0.0;
+
+    if (axis == DIRECTION_E) {
+        for (size_t y = 0u ; y < height ; y++) {
+            row = values + (y * width);
+            filtered_row = filtered + (y * width);
+
+            // the row is copied with the cells wrapped around each of its edges, only these being wrapped
+            for (i64 i = 0 ; i < (w + (2 * r) + 1) ; i++) {
+                scratch[i] = row[(((i - r) % w) + w) % w];
+            }
+
+            // the first mean is summed cell by cell, then a cell enters the mean and another leaves it with each step
+            sum = 0.0;
+            for (i64 i = 0 ; i <= (2 * r) ; i++) {
+                sum += scratch[i];
+            }
+            for (i64 i = 0 ; i < w ; i++) {
+                filtered_row[i] = (f32) (sum / cells_nb);
+
+                sum += scratch[i + (2 * r) + 1];
+                sum -= scratch[i];
+            }
+        }
+
+        return;
+    }
+
+    // the lines starting on the first row, one for each column, are summed at once in the scratch
+    for (size_t x = 0u ; x < width ; x++) {
+        scratch[x] = 0.0;
+    }
+    for (i64 i = -r ; i <= r ; i++) {
+        row = values + ((size_t) (((i % h) + h) % h) * width);
+        filter_rows_slide(scratch, row, width, filter_line_shift(axis, i, w), 0u);
+    }
+
+    for (i64 i = 0 ; i < h ; i++) {
+        filtered_row = filtered + ((size_t) i * width);
+        shift = filter_line_shift(axis, i, w);
+        split = width - shift;
+
+        for (size_t x = 0u ; x < split ; x++) {
+            filtered_row[x + shift] = (f32) (scratch[x] / cells_nb);
+        }
+        for (size_t x = split ; x < width ; x++) {
+            filtered_row[x - split] = (f32) (scratch[x] / cells_nb);
+        }
+
+        // then a row enters the sums and another leaves them with each step
+        row = values + ((size_t) ((((i + r + 1) % h) + h) % h) * width);
+        filter_rows_slide(scratch, row, width, filter_line_shift(axis, i + r + 1, w), 0u);
+        row = values + ((size_t) ((((i - r) % h) + h) % h) * width);
+        filter_rows_slide(scratch, row, width, filter_line_shift(axis, i - r, w), 1u);
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static f32 scalar_read(const void *field, otomaton_scalar_t type) {
+    switch (type) {
+        case OTOMATON_SCALAR_I8:
+            return (f32) *((const i8 *) field);
+        case OTOMATON_SCALAR_I16:
+            return (f32) *((const i16 *) field);
+        case OTOMATON_SCALAR_U16:
+            return (f32) *((const u16 *) field);
+        default:
+            return *((const f32 *) field);
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static void scalar_write(void *field, otomaton_scalar_t type, f32 value) {
+    switch (type) {
+        case OTOMATON_SCALAR_I8:
+            *((i8 *) field) = (i8) MIN(MAX(roundf(value), -128.0f), 127.0f);
+            break;
+        case OTOMATON_SCALAR_I16:
+            *((i16 *) field) = (i16) MIN(MAX(roundf(value), -32768.0f), 32767.0f);
+            break;
+        case OTOMATON_SCALAR_U16:
+            *((u16 *) field) = (u16) MIN(MAX(roundf(value), 0.0f), 65535.0f);
+            break;
+        default:
+            *((f32 *) field) = value;
+            break;
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_carve(cell_automaton_t *automaton, const automaton_layout_t *layout, size_t width, size_t height, size_t stride) {
+    u8 *block = (u8 *) automaton->arena.block;
+    size_t rows_in_cache = 0u;
+
+    for (size_t i = 0u ; i < layout->buffers_nb ; i++) {
+        pendulum_buffer_initialize(automaton->pendulum_buffers + i, width, height, stride, layout->halo_width, block + layout->buffers[i]);
+    }
+    for (size_t i = layout->buffers_nb ; i < PENDULUM_ARRAY_PAIR_NB ; i++) {
+        automaton->pendulum_buffers[i] = (pendulum_buffer_t) { 0u };
+    }
+    automaton->live_buffer_index = 0u;
+
+    // both buffers share the same layout
+    pendulum_buffer_neighbor_offsets(automaton->neighbor_offsets, automaton->pendulum_buffers);
+
+    automaton_bands_split(automaton, layout->bands_nb, (automaton_band_t *) (block + layout->bands), block + layout->previous_rows);
+
+    // a time block sweeps two rows of each buffer for each of its iterations, plus the rows around them, and
+    // leaves at least a row of each band to each of its iterations
+    rows_in_cache = TIME_BLOCK_CACHE_SIZE / MAX(PENDULUM_ARRAY_PAIR_NB * automaton->pendulum_buffers[0u].data.pitch, 1u);
+    automaton->block_depth = (u32) MIN((rows_in_cache > 2u) ? ((rows_in_cache - 2u) / 2u) : 0u, (height / automaton->bands_nb) / 2u);
+
+    // no cell was stamped yet
+    if (layout->frontier_stamps) {
+        automaton->frontier = (automaton_frontier_t) {
+                .changed_cells = { (u32 *) (block + layout->frontier_changed_cells[0u]), (u32 *) (block + layout->frontier_changed_cells[1u]) },
+                .candidates = (u32 *) (block + layout->frontier_candidates),
+                .stamps = (u32 *) (block + layout->frontier_stamps),
+                .previous_cell = block + layout->frontier_previous_cell,
+                .is_carved = 1u };
+        memset(automaton->frontier.stamps, 0, MAX(width * height, 1u) * sizeof(u32));
+    }
+
+    if (layout->mask_cells) {
+        automaton->mask = (automaton_mask_t) {
+                .cells = block + layout->mask_cells,
+                .runs = (u32 (*)[2u]) (block + layout->mask_runs),
+                .rows_runs = (size_t *) (block + layout->mask_rows_runs),
+                .is_carved = 1u };
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_layout(automaton_layout_t *layout, size_t width, size_t height, size_t stride, const otomaton_capacity_t *capacity, task_pool_t *pool) {
+    size_t buffer_size = 0u;
+
+    // the automaton and the parts that do not depend on the dimensions first, so they stay in place when it is resized
+    layout->size = ARENA_ALIGN(sizeof(cell_automaton_t));
+
+    // the halo is as wide as the widest disk the automaton will read, which also sets the room for its offsets
+    layout->halo_width = MAX(HALO_WIDTH, capacity->disk_radius);
+    for (size_t i = 0u ; i < ROW_PARITIES_NB ; i++) {
+        layout->disk_offsets[i] = layout->size;
+        layout->size += ARENA_ALIGN(OTOMATON_DISK_NEIGHBORS_NB(layout->halo_width) * sizeof(i64));
+    }
+
+    // then the buffers, on cache lines of their own. An automaton changed in place never reads a second one
+    layout->buffers_nb = (capacity->in_place_only) ? 1u : PENDULUM_ARRAY_PAIR_NB;
+    buffer_size = ARENA_ALIGN(pendulum_buffer_size(width, height, stride, layout->halo_width));
+    for (size_t i = 0u ; i < layout->buffers_nb ; i++) {
+        layout->buffers[i] = layout->size;
+        layout->size += buffer_size;
+    }
+
+    layout->bands_nb = automaton_bands_nb(height, pool);
+    layout->bands = layout->size;
+    layout->size += ARENA_ALIGN(layout->bands_nb * sizeof(automaton_band_t));
+    layout->previous_rows = layout->size;
+    layout->size += ARENA_ALIGN(MAX(layout->bands_nb * width * stride, 1u));
+
+    // the frontier and the mask last, so asking for them costs nothing to the automatons that do not
+    if (capacity->has_frontier && ((width * height) <= FRONTIER_CELLS_MAX)) {
+        for (size_t i = 0u ; i < PENDULUM_ARRAY_PAIR_NB ; i++) {
+            layout->frontier_changed_cells[i] = layout->size;
+            layout->size += ARENA_ALIGN(MAX(width * height, 1u) * sizeof(u32));
+        }
+        layout->frontier_candidates = layout->size;
+        layout->size += ARENA_ALIGN(MAX(width * height, 1u) * sizeof(u32));
+        layout->frontier_stamps = layout->size;
+        layout->size += ARENA_ALIGN(MAX(width * height, 1u) * sizeof(u32));
+        layout->frontier_previous_cell = layout->size;
+        layout->size += ARENA_ALIGN(MAX(stride, 1u));
+    }
+
+    // a row holds at most a run every other cell
+    if (capacity->has_mask) {
+        layout->mask_cells = layout->size;
+        layout->size += ARENA_ALIGN(MAX(width * height, 1u) * sizeof(u8));
+        layout->mask_runs = layout->size;
+        layout->size += ARENA_ALIGN(MAX(height * ((width + 1u) / 2u), 1u) * sizeof(u32[2u]));
+        layout->mask_rows_runs = layout->size;
+        layout->size += ARENA_ALIGN((height + 1u) * sizeof(size_t));
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static u32 automaton_arena_allocate(automaton_arena_t *arena, size_t size) {
+    void *mapped = MAP_FAILED;
+
+    *arena = (automaton_arena_t) { .block = NULL, .size = size, .is_mapped = 0u };
+
+    // small arenas would waste most of a huge page
+    if (size >= HUGE_PAGE_SIZE) {
+        arena->size = (size + HUGE_PAGE_SIZE - 1u) & ~((size_t) HUGE_PAGE_SIZE - 1u);
+
+#ifdef MAP_HUGETLB
+        // huge pages set aside by the system, rarely there are any
+        mapped = mmap(NULL, arena->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+        if (mapped == MAP_FAILED) {
+            mapped = mmap(NULL, arena->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+            // contengency : only a hint, the pages stay regular ones if the system declines
+            if (mapped != MAP_FAILED) {
+                (void) madvise(mapped, arena->size, MADV_HUGEPAGE);
+            }
+#endif
+        }
+
+        if (mapped != MAP_FAILED) {
+            arena->block = mapped;
+            arena->is_mapped = 1u;
+            return 1u;
+        }
+
+        arena->size = size;
+    }
+
+    arena->block = aligned_alloc(ARENA_ALIGNMENT, ARENA_ALIGN(size));
+
+    return (arena->block != NULL);
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_arena_release(automaton_arena_t *arena) {
+    if (arena->is_mapped) {
+        munmap(arena->block, arena->size);
+    } else {
+        free(arena->block);
+    }
+
+    arena->block = NULL;
+    arena->size = 0u;
+    arena->is_mapped = 0u;
+}
+
+// -------------------------------------------------------------------------------------------------
+static size_t automaton_bands_nb(size_t height, task_pool_t *pool) {
+    const size_t thread_nb = taskpool_thread_nb(pool);
+
+    // a single thread has no one to share its bands with
+    if (thread_nb > 1u) {
+        return MAX(MIN(thread_nb * BANDS_PER_THREAD, height), 1u);
+    }
+
+    return 1u;
+}
+
+// -------------------------------------------------------------------------------------------------
+static void automaton_bands_split(cell_automaton_t *automaton, size_t bands_nb, automaton_band_t *bands, void *previous_rows) {
+    const size_t height = automaton->pendulum_buffers[0u].data.height;
+    const size_t row_size = automaton->pendulum_buffers[0u].data.width * automaton->pendulum_buffers[0u].data.stride;
+
+    automaton->bands = bands;
+    automaton->previous_rows = previous_rows;
+    automaton->job = (automaton_job_t) { 0u };
+    automaton->bands_nb = bands_nb;
+
+    // bands of (almost) equal height, the first ones taking the remainder
+    for (size_t i = 0u ; i < bands_nb ; i++) {
+        automaton->bands[i] = (automaton_band_t) {
+                .automaton = automaton,
+                .band_start = (i * (height / bands_nb)) + MIN(i, height % bands_nb),
+                .previous_row = automaton->previous_rows + (i * row_size),
+                .changed_cells_nb = 0u };
+        automaton->bands[i].band_end = automaton->bands[i].band_start + (height / bands_nb) + (i < (height % bands_nb));
+    }
+}
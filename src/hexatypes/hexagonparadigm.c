@@ -11,10 +11,44 @@
 #include <hexagonparadigm.h>
 
 #include <math.h>
+#include <stddef.h>
 
 #include <raylib.h>
 #include <colorpalette.h>
 
+#define FIXED16_ONE (0xFFFFu)    ///< 1.0f in 16 bits of fixed point
+#define FIXED8_ONE (0xFFu)       ///< 1.0f in 8 bits of fixed point
+#define FIXED16_TURN (65536.0f)  ///< a whole turn in 16 bits of fixed point
+
+_Static_assert(sizeof(hexa_cell_packed_t) == 20u, "a packed cell must stay within 20 bytes");
+
+/// offset and size of each field of a cell
+#define HEXA_CELL_FIELD_SPAN(_member) { offsetof(hexa_cell_t, _member), sizeof(((hexa_cell_t *) NULL)->_member) }
+
+/**
+ * @brief Offset and size, in bytes, of each field of a cell.
+ */
+static const size_t hexa_cell_field_spans[HEXAW_FIELDS_NB][2u] = {
+        [HEXAW_FIELD_TELLURIC_VECTOR]               = HEXA_CELL_FIELD_SPAN(telluric_vector),
+        [HEXAW_FIELD_WINDS_VECTOR]                  = HEXA_CELL_FIELD_SPAN(winds_vector),
+        [HEXAW_FIELD_FRESHWATER_DIRECTION]          = HEXA_CELL_FIELD_SPAN(freshwater_direction),
+        [HEXAW_FIELD_CLOUD_COVER]                   = HEXA_CELL_FIELD_SPAN(cloud_cover),
+        [HEXAW_FIELD_PRECIPITATIONS]                = HEXA_CELL_FIELD_SPAN(precipitations),
+        [HEXAW_FIELD_VEGETATION_COVER]              = HEXA_CELL_FIELD_SPAN(vegetation_cover),
+        [HEXAW_FIELD_VEGETATION_TREES]              = HEXA_CELL_FIELD_SPAN(vegetation_trees),
+        [HEXAW_FIELD_FLAGS]                         = HEXA_CELL_FIELD_SPAN(flags),
+        [HEXAW_FIELD_FRESHWATER_HEIGHT]             = HEXA_CELL_FIELD_SPAN(freshwater_height),
+        [HEXAW_FIELD_ALTITUDE]                      = HEXA_CELL_FIELD_SPAN(altitude),
+        [HEXAW_FIELD_TEMPERATURE]                   = HEXA_CELL_FIELD_SPAN(temperature),
+        [HEXAW_FIELD_FRESHWATER_SOURCES_DIRECTIONS] = HEXA_CELL_FIELD_SPAN(freshwater_sources_directions),
+};
+
+// -------------------------------------------------------------------------------------------------
+void hexa_cell_field_span(hexa_cell_field_t field, size_t *out_offset, size_t *out_size) {
+    *out_offset = hexa_cell_field_spans[field][0u];
+    *out_size = hexa_cell_field_spans[field][1u];
+}
+
 // -------------------------------------------------------------------------------------------------
 void hexa_cell_set_flag(hexa_cell_t *cell, u32 flag) {
     cell->flags = (cell->flags | (0x01 << flag));
@@ -25,6 +59,93 @@ u32 hexa_cell_has_flag(hexa_cell_t *cell, u32 flag) {
     return ((cell->flags & (0x01 << flag)) != 0);
 }
 
+// -------------------------------------------------------------------------------------------------
+void hexa_cell_pack(const hexa_cell_t *cell, hexa_cell_packed_t *out_packed) {
+    *out_packed = (hexa_cell_packed_t) {
+            .flags = cell->flags,
+            .altitude = cell->altitude,
+            .freshwater_height = cell->freshwater_height,
+
+            .cloud_cover = ratio_to_fixed16(cell->cloud_cover),
+            .precipitations = ratio_to_fixed16(cell->precipitations),
+            .winds_angle = angle_to_fixed16(cell->winds_vector.angle),
+
+            // the plates' angles are all a multiple of a direction
+            .telluric_direction = (u16) lroundf(cell->telluric_vector.angle / (PI_T_2 / HEXA_PACKED_DIRECTIONS_NB)) % HEXA_PACKED_DIRECTIONS_NB,
+            .telluric_is_set = (cell->telluric_vector.magnitude > 0.5f),
+            .freshwater_direction = cell->freshwater_direction,
+            .freshwater_sources_directions = cell->freshwater_sources_directions,
+
+            .winds_magnitude = ratio_to_fixed8(cell->winds_vector.magnitude),
+            .vegetation_cover = ratio_to_fixed8(cell->vegetation_cover),
+            .vegetation_trees = ratio_to_fixed8(cell->vegetation_trees),
+
+            .temperature = cell->temperature,
+    };
+}
+
+// -------------------------------------------------------------------------------------------------
+void hexa_cell_unpack(const hexa_cell_packed_t *packed, hexa_cell_t *out_cell) {
+    *out_cell = (hexa_cell_t) {
+            .telluric_vector = {
+                    .angle = packed->telluric_direction * (PI_T_2 / HEXA_PACKED_DIRECTIONS_NB),
+                    .magnitude = (f32) packed->telluric_is_set,
+            },
+            .winds_vector = {
+                    .angle = angle_from_fixed16(packed->winds_angle),
+                    .magnitude = ratio_from_fixed8(packed->winds_magnitude),
+            },
+
+            .freshwater_direction = (cell_direction_t) packed->freshwater_direction,
+
+            .cloud_cover = ratio_from_fixed16(packed->cloud_cover),
+            .precipitations = ratio_from_fixed16(packed->precipitations),
+            .vegetation_cover = ratio_from_fixed8(packed->vegetation_cover),
+            .vegetation_trees = ratio_from_fixed8(packed->vegetation_trees),
+
+            .flags = packed->flags,
+            .freshwater_height = packed->freshwater_height,
+            .altitude = packed->altitude,
+            .temperature = packed->temperature,
+            .freshwater_sources_directions = packed->freshwater_sources_directions,
+    };
+}
+
+// -------------------------------------------------------------------------------------------------
+ratio16_t ratio_to_fixed16(ratio_t ratio) {
+    return (ratio16_t) lroundf(MIN(MAX(ratio, 0.0f), 1.0f) * (f32) FIXED16_ONE);
+}
+
+// -------------------------------------------------------------------------------------------------
+ratio_t ratio_from_fixed16(ratio16_t fixed) {
+    return (ratio_t) fixed / (ratio_t) FIXED16_ONE;
+}
+
+// -------------------------------------------------------------------------------------------------
+ratio8_t ratio_to_fixed8(ratio_t ratio) {
+    return (ratio8_t) lroundf(MIN(MAX(ratio, 0.0f), 1.0f) * (f32) FIXED8_ONE);
+}
+
+// -------------------------------------------------------------------------------------------------
+ratio_t ratio_from_fixed8(ratio8_t fixed) {
+    return (ratio_t) fixed / (ratio_t) FIXED8_ONE;
+}
+
+// -------------------------------------------------------------------------------------------------
+angle16_t angle_to_fixed16(f32 angle) {
+    f32 turns = fmodf(angle / PI_T_2, 1.0f);
+
+    turns += (turns < 0.0f);
+
+    // a turn rounded up to a whole one is the angle 0
+    return (angle16_t) (lroundf(turns * FIXED16_TURN) & 0xFFFF);
+}
+
+// -------------------------------------------------------------------------------------------------
+f32 angle_from_fixed16(angle16_t fixed) {
+    return ((f32) fixed / FIXED16_TURN) * PI_T_2;
+}
+
 // -------------------------------------------------------------------------------------------------
 void hexa_cell_get_surrounding_cells_pointed(f32 angle, size_t *out_pointed_cells_indexes, ratio_t *out_pointed_cells_ratios) {
     const f32 bound_angle = fmodf(angle, PI_T_2);
@@ -6,6 +6,7 @@
 
 #include <endoftheline.h>
 #include <hexaworld_application.h>
+#include <hexaworld_benchmark.h>
 #include <unstandard.h>
 
 static void intHandler(int val) {
@@ -21,6 +22,13 @@ i32 main(u32 argc, char const *argv[]) {
     i32 seed = 0;
     u32 width = 20u;
     u32 height = 20u;
+    u32 threads = 1u;
+    u32 coarse_levels = 0u;
+    f64 budget = 0.0;
+    u32 benchmark = 0u;
+    u32 storage = 0u;
+    const char *storage_names[] = { "dense", "packed", "sparse" };
+    u32 is_storage_known = 0u;
 
     // fetching command-line args
     while (index_args < argc) {
@@ -33,15 +41,44 @@ i32 main(u32 argc, char const *argv[]) {
         } else if ((strcmp(argv[index_args], "-y") == 0) && ((index_args + 1u) < argc)) {
             index_args += 1u;
             height = strtoul(argv[index_args], NULL, 0);
+        } else if ((strcmp(argv[index_args], "-j") == 0) && ((index_args + 1u) < argc)) {
+            index_args += 1u;
+            threads = strtoul(argv[index_args], NULL, 0);
+        } else if ((strcmp(argv[index_args], "-c") == 0) && ((index_args + 1u) < argc)) {
+            index_args += 1u;
+            coarse_levels = strtoul(argv[index_args], NULL, 0);
+        } else if ((strcmp(argv[index_args], "-t") == 0) && ((index_args + 1u) < argc)) {
+            index_args += 1u;
+            budget = strtod(argv[index_args], NULL);
+        } else if ((strcmp(argv[index_args], "-k") == 0) && ((index_args + 1u) < argc)) {
+            index_args += 1u;
+            is_storage_known = 0u;
+            for (size_t i = 0u ; i < (sizeof(storage_names) / sizeof(storage_names[0u])) ; i++) {
+                if (strcmp(argv[index_args], storage_names[i]) == 0) {
+                    storage = (u32) i;
+                    is_storage_known = 1u;
+                }
+            }
+            if (!is_storage_known) {
+                end_of_the_line(END_OF_THE_LINE_EXIT_INVALID_ARGS, "\n\tunknown storage, expected one of : dense, packed, sparse\n");
+                return -1;
+            }
+        } else if (strcmp(argv[index_args], "-b") == 0) {
+            benchmark = 1u;
         } else {
-            end_of_the_line(END_OF_THE_LINE_EXIT_INVALID_ARGS, "\n\tusage :\n\t$ otomaton [-s seed] [-x width] [-y height]\n");
+            end_of_the_line(END_OF_THE_LINE_EXIT_INVALID_ARGS, "\n\tusage :\n\t$ otomaton [-s seed] [-x width] [-y height] [-j threads] [-c coarse levels] [-t budget ms] [-k dense|packed|sparse] [-b]\n");
             return -1;
         }
         index_args += 1u;
     }
 
+    // measuring the generation without any window
+    if (benchmark) {
+        return (hexaworld_benchmark(seed, width, height, threads, coarse_levels, budget)) ? 0 : 1;
+    }
+
     // creating application
-    application = hexaworld_raylib_app_init(seed, 1200u, 800u, width, height);
+    application = hexaworld_raylib_app_init(seed, 1200u, 800u, width, height, threads, coarse_levels, budget, storage);
 
     // running the application
     hexaworld_raylib_app_run(application, 20u);
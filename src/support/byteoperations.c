@@ -1,15 +1,12 @@
 
 #include <unstandard.h>
 
+#include <string.h>
+
 // -------------------------------------------------------------------------------------------------
 void bytewise_copy(void *dest, void *source, size_t nb_bytes) {
-    char *byte_dest = (char *) dest;
-    char *byte_source = (char *) source;
-    char *byte_end = ((char *) source) + nb_bytes;
-
-    while (byte_source != byte_end) {
-        *(byte_dest++) = *(byte_source++);
-    }
+    // the libc copies whole words at a time, and also handles overlapping regions
+    memmove(dest, source, nb_bytes);
 }
 
 // -------------------------------------------------------------------------------------------------
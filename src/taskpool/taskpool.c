@@ -0,0 +1,444 @@
+/**
+ * @file taskpool.c
+ * @author gabriel 
+ * @brief Definition file for the task pool.
+ * @version 0.1
+ * @date 2023-04-23
+ * 
+ * @copyright Copyright (c) 2023
+ * 
+ */
+#include <taskpool.h>
+
+#include <stdlib.h>
+#include <pthread.h>
+
+// -------------------------------------------------------------------------------------------------
+// ---- CONSTANTS ----------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+#define TASK_QUEUE_INITIAL_CAPACITY (64u)   ///< number of tasks a queue can hold before growing
+#define SHARED_QUEUE_INDEX (0u)             ///< queue of the threads outside of the pool
+
+// -------------------------------------------------------------------------------------------------
+// ---- TYPE DEFINITIONS ---------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief A task waiting to be run.
+ */
+typedef struct task_t {
+    /// function run by the task
+    task_func_t function;
+    /// argument given to the function
+    void *argument;
+    /// group notified when the task is done
+    task_group_t *group;
+} task_t;
+
+/**
+ * @brief Double-ended queue of tasks, stored in a ring. The owner pushes and pops tasks at the bottom, the other
+ * threads steal them from the top.
+ */
+typedef struct task_queue_t {
+    /// held while the queue is read or changed
+    pthread_mutex_t lock;
+    /// ring of tasks
+    task_t *tasks;
+    /// number of tasks the ring can hold
+    size_t capacity;
+    /// index of the task at the top of the queue
+    size_t top;
+    /// number of tasks in the queue
+    size_t tasks_nb;
+} task_queue_t;
+
+/**
+ * @brief An additional thread of a pool, running tasks from its own queue first.
+ */
+typedef struct task_pool_worker_t {
+    /// pool owning the worker
+    struct task_pool_t *pool;
+    /// index of the worker's queue
+    size_t queue_index;
+    /// thread running the worker
+    pthread_t thread;
+} task_pool_worker_t;
+
+/**
+ * @brief Definition of a task pool.
+ */
+typedef struct task_pool_t {
+    /// one queue for each additional thread, plus the shared queue
+    task_queue_t *queues;
+    /// additional threads, the first one is unused as the shared queue has no thread of its own
+    task_pool_worker_t *workers;
+    /// number of queues, which is also the number of threads running the tasks
+    size_t queues_nb;
+
+    /// held while the counters are read or changed, and while sleeping
+    pthread_mutex_t lock;
+    /// signaled when a task is submitted or a group is done
+    pthread_cond_t wake_up;
+    /// number of tasks in all queues
+    size_t queued_nb;
+    /// set when the threads must return
+    u32 stop;
+} task_pool_t;
+
+// -------------------------------------------------------------------------------------------------
+// ---- STATIC DATA --------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/// held while a pool spawns its threads
+static pthread_mutex_t spawn_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/// worker ran by the current thread, NULL if it is not one of the additional threads of a pool
+static _Thread_local task_pool_worker_t *current_worker = NULL;
+
+// -------------------------------------------------------------------------------------------------
+// ---- STATIC FUNCTIONS DECLARATIONS --------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Returns the index of the queue of the calling thread in a pool.
+ * 
+ * @param[in] pool target pool
+ * @return size_t index of the queue, the shared queue if the thread is not one of the pool's
+ */
+static size_t taskpool_queue_index(task_pool_t *pool);
+
+/**
+ * @brief Pushes a task at the bottom of a queue, growing the queue if it is full.
+ * 
+ * @param[inout] queue target queue
+ * @param[in] task pushed task
+ * @return u32 1 if the task was pushed, 0 if the queue could not grow
+ */
+static u32 task_queue_push(task_queue_t *queue, task_t task);
+
+/**
+ * @brief Takes the task at the bottom (the newest) or at the top (the oldest) of a queue.
+ * 
+ * @param[inout] queue target queue
+ * @param[in] from_bottom 1 to take the newest task, 0 to take the oldest
+ * @param[out] out_task taken task
+ * @return u32 1 if a task was taken, 0 if the queue was empty
+ */
+static u32 task_queue_take(task_queue_t *queue, u32 from_bottom, task_t *out_task);
+
+/**
+ * @brief Takes a task from the queue of the calling thread, or steals one from the other queues.
+ * 
+ * @param[inout] pool target pool
+ * @param[in] queue_index index of the queue of the calling thread
+ * @param[out] out_task taken task
+ * @return u32 1 if a task was taken, 0 if all the queues were empty
+ */
+static u32 taskpool_take(task_pool_t *pool, size_t queue_index, task_t *out_task);
+
+/**
+ * @brief Runs a task and notifies its group.
+ * 
+ * @param[inout] pool pool the task was taken from
+ * @param[in] task ran task
+ */
+static void taskpool_run(task_pool_t *pool, task_t task);
+
+/**
+ * @brief Main routine of the additional threads. Runs tasks until the pool asks it to stop.
+ * 
+ * @param[in] raw_worker pointer to the thread's worker
+ * @return void* always NULL
+ */
+static void *taskpool_worker_run(void *raw_worker);
+
+// -------------------------------------------------------------------------------------------------
+// ---- HEADER FUNCTIONS DEFINITIONS ---------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+// -------------------------------------------------------------------------------------------------
+task_pool_t *taskpool_create(size_t thread_nb) {
+    task_pool_t *pool = NULL;
+    size_t spawned_nb = 1u;
+
+    thread_nb = MAX(thread_nb, 1u);
+
+    pool = malloc(sizeof(*pool));
+    if (!pool) {
+        return NULL;
+    }
+
+    pool->queues = malloc(thread_nb * sizeof(*(pool->queues)));
+    pool->workers = malloc(thread_nb * sizeof(*(pool->workers)));
+    if ((!pool->queues) || (!pool->workers)) {
+        free(pool->queues);
+        free(pool->workers);
+        free(pool);
+        return NULL;
+    }
+
+    for (size_t i = 0u ; i < thread_nb ; i++) {
+        pthread_mutex_init(&(pool->queues[i].lock), NULL);
+        pool->queues[i].tasks = NULL;
+        pool->queues[i].capacity = 0u;
+        pool->queues[i].top = 0u;
+        pool->queues[i].tasks_nb = 0u;
+
+        pool->workers[i].pool = pool;
+        pool->workers[i].queue_index = i;
+    }
+
+    pthread_mutex_init(&(pool->lock), NULL);
+    pthread_cond_init(&(pool->wake_up), NULL);
+    pool->queued_nb = 0u;
+    pool->stop = 0u;
+
+    // the new threads wait for the lock to be released before looking at the queues, so their number can be
+    // set to the number of threads that really exist
+    pthread_mutex_lock(&spawn_lock);
+    for (size_t i = 1u ; i < thread_nb ; i++) {
+        if (pthread_create(&(pool->workers[i].thread), NULL, &taskpool_worker_run, pool->workers + i) != 0) {
+            break;
+        }
+        spawned_nb += 1u;
+    }
+    pool->queues_nb = spawned_nb;
+    pthread_mutex_unlock(&spawn_lock);
+
+    return pool;
+}
+
+// -------------------------------------------------------------------------------------------------
+size_t taskpool_thread_nb(task_pool_t *pool) {
+    if (!pool) {
+        return 1u;
+    }
+
+    return pool->queues_nb;
+}
+
+// -------------------------------------------------------------------------------------------------
+void taskpool_submit(task_pool_t *pool, task_group_t *group, task_func_t function, void *argument) {
+    task_t task = { .function = function, .argument = argument, .group = group };
+    task_queue_t *queue = NULL;
+
+    // nowhere to queue the task
+    if ((!pool) || (pool->queues_nb == 1u)) {
+        function(argument);
+        return;
+    }
+
+    queue = pool->queues + taskpool_queue_index(pool);
+
+    // the group and the queued task are counted before the task can be stolen and done, so neither count goes
+    // under zero
+    pthread_mutex_lock(&(pool->lock));
+    group->pending_nb += 1u;
+    pool->queued_nb += 1u;
+    pthread_mutex_unlock(&(pool->lock));
+
+    if (!task_queue_push(queue, task)) {
+        pthread_mutex_lock(&(pool->lock));
+        pool->queued_nb -= 1u;
+        pthread_mutex_unlock(&(pool->lock));
+
+        taskpool_run(pool, task);
+        return;
+    }
+
+    pthread_mutex_lock(&(pool->lock));
+    pthread_cond_broadcast(&(pool->wake_up));
+    pthread_mutex_unlock(&(pool->lock));
+}
+
+// -------------------------------------------------------------------------------------------------
+void taskpool_wait(task_pool_t *pool, task_group_t *group) {
+    task_t task = { 0u };
+    size_t queue_index = 0u;
+
+    if (!pool) {
+        return;
+    }
+
+    queue_index = taskpool_queue_index(pool);
+
+    while (1) {
+        pthread_mutex_lock(&(pool->lock));
+        if (group->pending_nb == 0u) {
+            pthread_mutex_unlock(&(pool->lock));
+            return;
+        }
+        pthread_mutex_unlock(&(pool->lock));
+
+        // helping instead of waiting
+        if (taskpool_take(pool, queue_index, &task)) {
+            taskpool_run(pool, task);
+            continue;
+        }
+
+        // the group's last tasks are being run by other threads
+        pthread_mutex_lock(&(pool->lock));
+        while ((group->pending_nb > 0u) && (pool->queued_nb == 0u)) {
+            pthread_cond_wait(&(pool->wake_up), &(pool->lock));
+        }
+        pthread_mutex_unlock(&(pool->lock));
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+void taskpool_destroy(task_pool_t **pool) {
+    if (*pool) {
+        pthread_mutex_lock(&((*pool)->lock));
+        (*pool)->stop = 1u;
+        pthread_cond_broadcast(&((*pool)->wake_up));
+        pthread_mutex_unlock(&((*pool)->lock));
+
+        for (size_t i = 1u ; i < (*pool)->queues_nb ; i++) {
+            pthread_join((*pool)->workers[i].thread, NULL);
+        }
+
+        for (size_t i = 0u ; i < (*pool)->queues_nb ; i++) {
+            pthread_mutex_destroy(&((*pool)->queues[i].lock));
+            free((*pool)->queues[i].tasks);
+        }
+        pthread_cond_destroy(&((*pool)->wake_up));
+        pthread_mutex_destroy(&((*pool)->lock));
+
+        free((*pool)->queues);
+        free((*pool)->workers);
+        free(*pool);
+    }
+    *pool = NULL;
+}
+
+// -------------------------------------------------------------------------------------------------
+// ---- STATIC FUNCTIONS DEFINITIONS ---------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+// -------------------------------------------------------------------------------------------------
+static size_t taskpool_queue_index(task_pool_t *pool) {
+    if ((!current_worker) || (current_worker->pool != pool)) {
+        return SHARED_QUEUE_INDEX;
+    }
+
+    return current_worker->queue_index;
+}
+
+// -------------------------------------------------------------------------------------------------
+static u32 task_queue_push(task_queue_t *queue, task_t task) {
+    task_t *grown_tasks = NULL;
+    size_t grown_capacity = 0u;
+
+    pthread_mutex_lock(&(queue->lock));
+
+    if (queue->tasks_nb == queue->capacity) {
+        grown_capacity = MAX(2u * queue->capacity, TASK_QUEUE_INITIAL_CAPACITY);
+        grown_tasks = malloc(grown_capacity * sizeof(*grown_tasks));
+        if (!grown_tasks) {
+            pthread_mutex_unlock(&(queue->lock));
+            return 0u;
+        }
+
+        // unrolling the ring from its top
+        for (size_t i = 0u ; i < queue->tasks_nb ; i++) {
+            grown_tasks[i] = queue->tasks[(queue->top + i) % queue->capacity];
+        }
+        free(queue->tasks);
+        queue->tasks = grown_tasks;
+        queue->capacity = grown_capacity;
+        queue->top = 0u;
+    }
+
+    queue->tasks[(queue->top + queue->tasks_nb) % queue->capacity] = task;
+    queue->tasks_nb += 1u;
+
+    pthread_mutex_unlock(&(queue->lock));
+
+    return 1u;
+}
+
+// -------------------------------------------------------------------------------------------------
+static u32 task_queue_take(task_queue_t *queue, u32 from_bottom, task_t *out_task) {
+    pthread_mutex_lock(&(queue->lock));
+
+    if (queue->tasks_nb == 0u) {
+        pthread_mutex_unlock(&(queue->lock));
+        return 0u;
+    }
+
+    queue->tasks_nb -= 1u;
+    if (from_bottom) {
+        *out_task = queue->tasks[(queue->top + queue->tasks_nb) % queue->capacity];
+    } else {
+        *out_task = queue->tasks[queue->top];
+        queue->top = (queue->top + 1u) % queue->capacity;
+    }
+
+    pthread_mutex_unlock(&(queue->lock));
+
+    return 1u;
+}
+
+// -------------------------------------------------------------------------------------------------
+static u32 taskpool_take(task_pool_t *pool, size_t queue_index, task_t *out_task) {
+    u32 taken = 0u;
+
+    // the newest task of its own queue is the most likely to still be in the thread's cache
+    taken = task_queue_take(pool->queues + queue_index, 1u, out_task);
+    for (size_t i = 1u ; (i < pool->queues_nb) && (!taken) ; i++) {
+        taken = task_queue_take(pool->queues + ((queue_index + i) % pool->queues_nb), 0u, out_task);
+    }
+
+    if (taken) {
+        pthread_mutex_lock(&(pool->lock));
+        pool->queued_nb -= 1u;
+        pthread_mutex_unlock(&(pool->lock));
+    }
+
+    return taken;
+}
+
+// -------------------------------------------------------------------------------------------------
+static void taskpool_run(task_pool_t *pool, task_t task) {
+    task.function(task.argument);
+
+    pthread_mutex_lock(&(pool->lock));
+    task.group->pending_nb -= 1u;
+    if (task.group->pending_nb == 0u) {
+        pthread_cond_broadcast(&(pool->wake_up));
+    }
+    pthread_mutex_unlock(&(pool->lock));
+}
+
+// -------------------------------------------------------------------------------------------------
+static void *taskpool_worker_run(void *raw_worker) {
+    task_pool_worker_t *worker = (task_pool_worker_t *) raw_worker;
+    task_pool_t *pool = worker->pool;
+    task_t task = { 0u };
+
+    // waiting for the spawning thread to be done with the pool
+    pthread_mutex_lock(&spawn_lock);
+    pthread_mutex_unlock(&spawn_lock);
+
+    current_worker = worker;
+
+    while (1) {
+        if (taskpool_take(pool, worker->queue_index, &task)) {
+            taskpool_run(pool, task);
+            continue;
+        }
+
+        pthread_mutex_lock(&(pool->lock));
+        while ((pool->queued_nb == 0u) && (!pool->stop)) {
+            pthread_cond_wait(&(pool->wake_up), &(pool->lock));
+        }
+        if (pool->stop) {
+            pthread_mutex_unlock(&(pool->lock));
+            break;
+        }
+        pthread_mutex_unlock(&(pool->lock));
+    }
+
+    return NULL;
+}